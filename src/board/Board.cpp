@@ -517,6 +517,17 @@ void Board::updateZobrist(const Move &move, const MoveState &state) noexcept
         hash ^= zobristEnPassant[newEp & 7];
 }
 
+// A null move only flips the side to move and clears en passant
+void Board::updateZobristNullMove(const MoveState &state) noexcept
+{
+    hash ^= zobristSide;
+
+    if (state.enPassantSquare != -1)
+        hash ^= zobristEnPassant[state.enPassantSquare & 7];
+    if (enPassantSquare != -1)
+        hash ^= zobristEnPassant[enPassantSquare & 7];
+}
+
 uint64_t Board::computeZobrist() const
 {
     uint64_t h = 0;
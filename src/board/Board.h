@@ -92,6 +92,7 @@ public:
     void setPiece(Piece piece, Color color, int square);
     bool isDraw() const;
     void updateZobrist(const Move &move, const MoveState &state) noexcept;
+    void updateZobristNullMove(const MoveState &state) noexcept;
     uint64_t computeZobrist() const;
     std::pair<Piece, Color> findPiece(int square) const;
     static int squareFromString(const std::string &square);
@@ -267,6 +267,39 @@ void MoveGen::unmakeMove(Board &board, const Move &move, const MoveState &state)
     }
 }
 
+// Passes the turn without moving a piece (used by null-move pruning)
+void MoveGen::makeNullMove(Board &board, MoveState &state)
+{
+    state.castlingMask = board.castlingMask;
+    state.enPassantSquare = board.enPassantSquare;
+    state.halfMoveClock = board.halfMoveClock;
+    state.moves = board.moves;
+    state.whiteToMove = board.whiteToMove;
+    state.capturedPiece = NONE;
+    state.capturedColor = BOTH;
+    state.capturedSquare = -1;
+
+    board.enPassantSquare = -1;
+    board.halfMoveClock++;
+    board.whiteToMove = !board.whiteToMove;
+    if (board.trackRepetitions)
+    {
+        board.updateZobristNullMove(state);
+    }
+}
+
+void MoveGen::unmakeNullMove(Board &board, const MoveState &state)
+{
+    if (board.trackRepetitions)
+    {
+        board.updateZobristNullMove(state);
+    }
+    board.enPassantSquare = state.enPassantSquare;
+    board.halfMoveClock = state.halfMoveClock;
+    board.moves = state.moves;
+    board.whiteToMove = state.whiteToMove;
+}
+
 void MoveGen::initAttackTables()
 {
     initPawnAttacks();
@@ -27,6 +27,8 @@ public:
     static void printAttackMap(const Board &board, Color attacker);
     static void makeMove(Board &board, const Move &move, MoveState &state);
     static void unmakeMove(Board &board, const Move &move, const MoveState &state);
+    static void makeNullMove(Board &board, MoveState &state);
+    static void unmakeNullMove(Board &board, const MoveState &state);
     static bool inCheck(const Board &board, Color color);
 
 private:
@@ -0,0 +1,284 @@
+#include "DeepPerft.h"
+#include "Perft.h"
+#include "MoveGen.h"
+
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+static void collectUnits(Board &board, int depth, std::vector<Move> &path, std::vector<PerftUnit> &units)
+{
+    if (depth == 0)
+    {
+        PerftUnit unit;
+        unit.path = path;
+        for (size_t i = 0; i < path.size(); ++i)
+        {
+            if (i)
+                unit.key += ' ';
+            unit.key += Move::moveToString(path[i]);
+        }
+        units.push_back(std::move(unit));
+        return;
+    }
+
+    std::vector<Move> moves;
+    MoveGen::generateLegalMoves(board, moves);
+    for (auto &m : moves)
+    {
+        MoveState st;
+        MoveGen::makeMove(board, m, st);
+        path.push_back(m);
+        collectUnits(board, depth - 1, path, units);
+        path.pop_back();
+        MoveGen::unmakeMove(board, m, st);
+    }
+}
+
+// Work units in generation order. Lines ending in mate or stalemate before
+// splitDepth produce no unit, matching their zero contribution to perft.
+std::vector<PerftUnit> splitPerft(Board &board, int splitDepth)
+{
+    std::vector<PerftUnit> units;
+    std::vector<Move> path;
+    collectUnits(board, splitDepth, path, units);
+    return units;
+}
+
+static std::string checkpointHeader(const DeepPerftConfig &config, int splitDepth, size_t unitCount)
+{
+    std::ostringstream header;
+    header << "# deep-perft fen=" << config.fen << " depth=" << config.depth
+           << " split=" << splitDepth << " units=" << unitCount;
+    return header.str();
+}
+
+// Reads completed units from an existing checkpoint. A trailing partial line
+// (the process died mid-write) is ignored.
+static std::map<size_t, uint64_t> loadCheckpoint(const std::string &path, const std::string &header,
+                                                 const std::vector<PerftUnit> &units, bool &exists)
+{
+    std::map<size_t, uint64_t> done;
+    std::ifstream in(path);
+    exists = in.good();
+    if (!exists)
+        return done;
+
+    std::string line;
+    if (!std::getline(in, line))
+    {
+        exists = false;
+        return done;
+    }
+    if (line != header)
+        throw std::runtime_error("checkpoint " + path + " belongs to a different run: " + line);
+
+    while (std::getline(in, line))
+    {
+        if (in.eof())
+            break; // no terminating newline, unit was not fully written
+
+        std::istringstream iss(line);
+        size_t index;
+        uint64_t nodes;
+        if (!(iss >> index >> nodes) || index >= units.size())
+            continue;
+        std::string key;
+        std::getline(iss >> std::ws, key);
+        if (key != units[index].key)
+            continue;
+        done[index] = nodes;
+    }
+    return done;
+}
+
+#ifndef _WIN32
+static void writeAll(int fd, const std::string &data)
+{
+    const char *p = data.data();
+    size_t left = data.size();
+    while (left > 0)
+    {
+        ssize_t n = ::write(fd, p, left);
+        if (n < 0)
+            throw std::runtime_error("failed writing checkpoint");
+        p += n;
+        left -= static_cast<size_t>(n);
+    }
+}
+
+static int openCheckpoint(const std::string &path, bool exists, const std::string &header)
+{
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0)
+        throw std::runtime_error("cannot open checkpoint " + path);
+
+    if (!exists)
+    {
+        writeAll(fd, header + "\n");
+    }
+    else
+    {
+        // Terminate a partial last line so new records start cleanly
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (in.tellg() > 0)
+        {
+            in.seekg(-1, std::ios::end);
+            if (in.get() != '\n')
+                writeAll(fd, "\n");
+        }
+    }
+    ::fsync(fd);
+    return fd;
+}
+
+struct RunningUnit
+{
+    size_t index;
+    int readFd;
+};
+
+static pid_t spawnWorker(const Board &root, const PerftUnit &unit, int remaining,
+                         unsigned int threads, int &readFd)
+{
+    int fds[2];
+    if (::pipe(fds) != 0)
+        throw std::runtime_error("pipe() failed");
+
+    pid_t pid = ::fork();
+    if (pid < 0)
+        throw std::runtime_error("fork() failed");
+
+    if (pid == 0)
+    {
+        ::close(fds[0]);
+        Board board = root;
+        for (const auto &m : unit.path)
+        {
+            MoveState st;
+            MoveGen::makeMove(board, m, st);
+        }
+        uint64_t nodes = remaining == 0 ? 1ULL : perftTest(board, remaining, threads);
+        ssize_t written = ::write(fds[1], &nodes, sizeof(nodes));
+        ::_exit(written == static_cast<ssize_t>(sizeof(nodes)) ? 0 : 1);
+    }
+
+    ::close(fds[1]);
+    readFd = fds[0];
+    return pid;
+}
+#endif
+
+uint64_t deepPerft(const DeepPerftConfig &config)
+{
+#ifdef _WIN32
+    (void)config;
+    throw std::runtime_error("deep perft requires fork() and is only supported on Linux");
+#else
+    Board board;
+    board.trackRepetitions = false;
+    if (config.fen.empty())
+        board.setBoard();
+    else
+        board.setCustomBoard(config.fen);
+
+    if (config.depth <= 0)
+        return 1ULL;
+    if (config.depth == 1)
+        return perftTest(board, 1, config.threads);
+
+    int splitDepth = std::max(1, std::min(config.splitDepth, config.depth - 1));
+    int remaining = config.depth - splitDepth;
+    std::vector<PerftUnit> units = splitPerft(board, splitDepth);
+
+    std::string header = checkpointHeader(config, splitDepth, units.size());
+    std::map<size_t, uint64_t> done;
+    int checkpointFd = -1;
+    if (!config.checkpointPath.empty())
+    {
+        bool exists = false;
+        done = loadCheckpoint(config.checkpointPath, header, units, exists);
+        checkpointFd = openCheckpoint(config.checkpointPath, exists, header);
+    }
+
+    uint64_t total = 0;
+    for (const auto &[index, nodes] : done)
+        total += nodes;
+
+    std::deque<size_t> pending;
+    for (size_t i = 0; i < units.size(); ++i)
+        if (!done.count(i))
+            pending.push_back(i);
+
+    if (config.verbose)
+        std::cout << "[DeepPerft] depth " << config.depth << ", " << units.size() << " units at split depth "
+                  << splitDepth << ", " << done.size() << " already done" << std::endl;
+
+    const unsigned int processes = std::max(1u, config.processes);
+    std::map<pid_t, RunningUnit> running;
+    std::map<size_t, int> failures;
+    size_t completed = done.size();
+
+    while (!pending.empty() || !running.empty())
+    {
+        while (!pending.empty() && running.size() < processes)
+        {
+            size_t index = pending.front();
+            pending.pop_front();
+            int readFd;
+            pid_t pid = spawnWorker(board, units[index], remaining, config.threads, readFd);
+            running[pid] = {index, readFd};
+        }
+
+        int status = 0;
+        pid_t pid = ::waitpid(-1, &status, 0);
+        if (pid < 0)
+            throw std::runtime_error("waitpid() failed");
+        auto it = running.find(pid);
+        if (it == running.end())
+            continue;
+
+        RunningUnit unit = it->second;
+        running.erase(it);
+
+        uint64_t nodes = 0;
+        bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+                  ::read(unit.readFd, &nodes, sizeof(nodes)) == static_cast<ssize_t>(sizeof(nodes));
+        ::close(unit.readFd);
+
+        if (!ok)
+        {
+            if (++failures[unit.index] > 2)
+                throw std::runtime_error("work unit failed repeatedly: " + units[unit.index].key);
+            pending.push_back(unit.index);
+            continue;
+        }
+
+        total += nodes;
+        completed++;
+        if (checkpointFd >= 0)
+        {
+            std::ostringstream record;
+            record << unit.index << ' ' << nodes << ' ' << units[unit.index].key << '\n';
+            writeAll(checkpointFd, record.str());
+            ::fsync(checkpointFd);
+        }
+        if (config.verbose)
+            std::cout << "[" << completed << "/" << units.size() << "] " << units[unit.index].key
+                      << ": " << nodes << std::endl;
+    }
+
+    if (checkpointFd >= 0)
+        ::close(checkpointFd);
+    return total;
+#endif
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Board.h"
+
+#include <string>
+#include <vector>
+
+// Splits a deep perft into work units at splitDepth, runs each unit in a
+// forked worker process and appends finished units to a checkpoint file,
+// so an interrupted run resumes where it stopped. Linux only (fork).
+struct DeepPerftConfig
+{
+    std::string fen;               // empty = start position
+    int depth = 8;
+    int splitDepth = 3;            // clamped to depth - 1
+    unsigned int processes = 1;    // concurrent worker processes
+    unsigned int threads = 1;      // perftTest threads inside each worker
+    std::string checkpointPath;    // empty = no checkpointing
+    bool verbose = true;
+};
+
+struct PerftUnit
+{
+    std::vector<Move> path;
+    std::string key; // path as space separated UCI moves
+};
+
+std::vector<PerftUnit> splitPerft(Board &board, int splitDepth);
+uint64_t deepPerft(const DeepPerftConfig &config);
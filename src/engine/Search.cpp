@@ -2,35 +2,226 @@
 #include "MoveGen.h"
 #include "Transposition.h"
 #include "Evaluation.h"
+#include "TimeManager.h"
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <climits>
+#include <cmath>
 #include <cstring>
 #include <iostream>
+#include <thread>
 
 static constexpr int MATE_SCORE = 1000000;
 static constexpr int INF = MATE_SCORE + 10000;
-static constexpr int MAX_PLY = 127;
-static constexpr int MAX_KILLER_PLY = 127;
+static constexpr int MAX_PLY = SearchWorker::MAX_PLY;
 
 static constexpr int TT_MOVE_SCORE = 1000000;
 static constexpr int CAPTURE_SCORE_BASE = 100000;
 static constexpr int PROMOTION_SCORE = 90000;
 static constexpr int KILLER_MOVE_SCORE = 80000;
+static constexpr int COUNTER_MOVE_SCORE = 70000;
 
-inline int mvvLvaScore(const Board &board, const Move &m)
+static constexpr int MVV_VALUE[6] = {100, 300, 325, 500, 900, 10000};
+static constexpr int CAPTURE_HISTORY_DIVISOR = 16; // history points per point of capture score
+
+// Piece removed by a capture; en passant leaves the destination square empty
+static Piece capturedPiece(const Board &board, const Move &m)
+{
+    if (m.isEnPassant)
+        return PAWN;
+    Piece victim = board.findPiece(m.to).first;
+    return victim == NONE ? PAWN : victim;
+}
+
+static constexpr int HISTORY_LIMIT = 16384; // history entries stay within +-HISTORY_LIMIT
+static constexpr int HISTORY_BONUS_MAX = 1200;
+
+static int historyBonus(int depth)
+{
+    return std::min(32 * depth * depth, HISTORY_BONUS_MAX);
+}
+
+// Gravity update: the closer an entry is to the limit, the less a bonus of
+// the same sign moves it, so entries stay bounded and recent results dominate
+template <typename T>
+static void applyHistoryBonus(T &entry, int bonus)
+{
+    entry += bonus - entry * std::abs(bonus) / HISTORY_LIMIT;
+}
+
+static constexpr int MAX_SEARCH_DEPTH = 64;
+static constexpr int ASPIRATION_MIN_DEPTH = 4;   // shallower iterations are too noisy to predict
+static constexpr int ASPIRATION_DELTA = 25;      // initial half-width in centipawns
+static constexpr int ASPIRATION_MAX_DELTA = 1000; // beyond this fall back to a full window
+static constexpr uint64_t LIMIT_CHECK_INTERVAL = 2048; // nodes between time/node budget checks
+static constexpr int64_t INFO_INTERVAL_MS = 1000;      // progress reports during long iterations
+
+int64_t SearchShared::elapsedMs() const
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// Pondering searches on the opponent's time; the clock only counts after ponderhit
+bool SearchShared::pondering() const
+{
+    return limits.ponder && limits.ponder->load(std::memory_order_relaxed);
+}
+
+bool SearchShared::limitReached(uint64_t totalNodes) const
+{
+    if (limits.stop && limits.stop->load(std::memory_order_relaxed))
+        return true;
+
+    if (limits.nodes && totalNodes >= limits.nodes)
+        return true;
+
+    return limits.timeMs && !pondering() && elapsedMs() >= limits.timeMs;
+}
+
+void SearchWorker::updatePV(int ply, const Move &m)
+{
+    pvTable[ply][ply] = m;
+    int childEnd = std::max(pvLength[ply + 1], ply + 1);
+    for (int i = ply + 1; i < childEnd; ++i)
+        pvTable[ply][i] = pvTable[ply + 1][i];
+    pvLength[ply] = childEnd;
+}
+
+SearchInfo SearchWorker::makeInfo(uint64_t totalNodes) const
+{
+    SearchInfo info;
+    info.depth = rootDepth;
+    info.selDepth = selDepth;
+    info.nodes = totalNodes;
+    info.timeMs = shared->elapsedMs();
+    info.nps = totalNodes * 1000 / static_cast<uint64_t>(std::max<int64_t>(info.timeMs, 1));
+    info.hashfull = tt.hashfull();
+    return info;
+}
+
+// Workers add their node counts to the shared total in steps of this size. A
+// node budget is enforced exactly, so with one set every node is published.
+static uint64_t publishInterval(const SearchLimits &limits)
+{
+    return limits.nodes ? 1 : LIMIT_CHECK_INTERVAL;
+}
+
+// Called on every node. Every LIMIT_CHECK_INTERVAL nodes the worker checks
+// the shared budgets and sends progress info; a node budget is checked
+// whenever nodes are published.
+bool SearchWorker::shouldStop()
+{
+    const uint64_t interval = publishInterval(shared->limits);
+    uint64_t total = 0;
+    if ((nodes & (interval - 1)) == 0)
+    {
+        total = shared->nodes.fetch_add(interval, std::memory_order_relaxed) + interval;
+        if (shared->limits.nodes && total >= shared->limits.nodes)
+            shared->stopped.store(true, std::memory_order_relaxed);
+    }
+
+    if ((nodes & (LIMIT_CHECK_INTERVAL - 1)) == 0)
+    {
+        if (shared->limitReached(total))
+            shared->stopped.store(true, std::memory_order_relaxed);
+
+        if (threadId == 0 && shared->limits.info && shared->elapsedMs() >= shared->nextInfoMs)
+        {
+            shared->nextInfoMs = shared->elapsedMs() + INFO_INTERVAL_MS;
+            shared->limits.info(makeInfo(total));
+        }
+    }
+    return shared->stopped.load(std::memory_order_relaxed);
+}
+
+static constexpr int NULL_MOVE_MIN_DEPTH = 3;
+static constexpr int NULL_MOVE_BASE_REDUCTION = 2;
+static constexpr int NULL_MOVE_DEPTH_DIVISOR = 4; // R = 2 + depth / 4
+static constexpr int NULL_MOVE_VERIFY_DEPTH = 10; // verify null-move cutoffs from this depth
+
+static constexpr int PROBCUT_MIN_DEPTH = 5;
+static constexpr int PROBCUT_MARGIN = 200;   // centipawns over beta the reduced search must reach
+static constexpr int PROBCUT_REDUCTION = 4;
+static constexpr int IIR_MIN_DEPTH = 4; // nodes without a TT move are reduced from this depth
+
+// Quiescence search
+static constexpr int QS_TT_DEPTH = 0;    // depth of qsearch TT entries, below every main-search entry
+static constexpr int DELTA_MARGIN = 200; // slack over the material won for delta pruning
+static constexpr uint64_t RANK_2 = 0x000000000000FF00ULL;
+static constexpr uint64_t RANK_7 = 0x00FF000000000000ULL;
+
+// Shallow-depth pruning margins in centipawns, indexed by remaining depth
+static constexpr int RFP_MAX_DEPTH = 6;
+static constexpr int RFP_MARGIN = 100; // per ply of remaining depth
+static constexpr int RAZOR_MAX_DEPTH = 3;
+static constexpr int RAZOR_MARGIN[RAZOR_MAX_DEPTH + 1] = {0, 300, 450, 600};
+static constexpr int FUTILITY_MAX_DEPTH = 3;
+static constexpr int FUTILITY_MARGIN[FUTILITY_MAX_DEPTH + 1] = {0, 150, 300, 450};
+
+static constexpr int LMR_MIN_DEPTH = 3;
+static constexpr int LMR_MIN_MOVES = 3;              // moves searched before reductions start
+static constexpr int LMR_HISTORY_DIVISOR = 8192;     // history points per ply of reduction change
+static constexpr int LMP_MAX_DEPTH = 8;
+
+static constexpr int SINGULAR_MIN_DEPTH = 8;
+static constexpr int SINGULAR_MARGIN = 2; // centipawns per ply below the TT score
+
+static constexpr int NO_EVAL = -INF;
+
+// Late move reduction for a quiet move, from a log(depth) x log(moveNumber) table
+static int lmrReduction(int depth, int moveNumber)
 {
-    static const int pieceValue[6] = {100, 300, 325, 500, 900, 10000};
-    // captured piece value – 0.1 × attacker value
-    Piece capturedPiece = board.findPiece(m.to).first;
-    return 10 * pieceValue[capturedPiece] - pieceValue[m.piece] / 10;
+    static const auto table = []
+    {
+        std::array<std::array<int, 64>, 64> t{};
+        for (int d = 1; d < 64; ++d)
+            for (int m = 1; m < 64; ++m)
+                t[d][m] = static_cast<int>(0.75 + std::log(d) * std::log(m) / 2.25);
+        return t;
+    }();
+    return table[std::min(depth, 63)][std::min(moveNumber, 63)];
+}
+
+// Mate scores are stored in the TT as distance from this node rather than
+// from the root, so an entry stays correct when reached at a different ply
+static int scoreToTT(int score, int ply)
+{
+    if (score > MATE_SCORE - MAX_PLY)
+        return score + ply;
+    if (score < -(MATE_SCORE - MAX_PLY))
+        return score - ply;
+    return score;
 }
 
-static TranspositionTable TT;
+static int scoreFromTT(int score, int ply)
+{
+    if (score > MATE_SCORE - MAX_PLY)
+        return score - ply;
+    if (score < -(MATE_SCORE - MAX_PLY))
+        return score + ply;
+    return score;
+}
+
+static inline bool isNullMove(const Move &m)
+{
+    return m.from == m.to;
+}
+
+static inline bool sameMove(const Move &a, const Move &b)
+{
+    return a.from == b.from && a.to == b.to && a.isPromotion == b.isPromotion &&
+           (!a.isPromotion || a.piece == b.piece);
+}
 
-static Move killerMoves[MAX_KILLER_PLY + 1][2];
-static int historyTable[6][64];
-static constexpr int HISTORY_MAX = INT_MAX / 2; // Prevent overflow
+static bool hasNonPawnMaterial(const Board &board, Color color)
+{
+    return (board.knights[color] | board.bishops[color] | board.rooks[color] | board.queens[color]) != 0;
+}
 
 static int materialCount(const Board &board)
 {
@@ -57,9 +248,9 @@ static int dynamicDepth(const Board &board)
         return DEPTH_MIDGAME;
 }
 
-void orderMoves(const Board &board, std::vector<Move> &moves, Move ttBestMove, int ply)
+void SearchWorker::orderMoves(const Board &board, std::vector<Move> &moves, Move ttBestMove, int ply) const
 {
-    assert(ply >= 0 && ply <= MAX_KILLER_PLY);
+    assert(ply >= 0 && ply <= MAX_PLY);
 
     // Check if we're in endgame and winning - favor simplifying trades
     bool isEndgame = false;
@@ -79,9 +270,17 @@ void orderMoves(const Board &board, std::vector<Move> &moves, Move ttBestMove, i
 
     if (isEndgame)
     {
-        int eval = evaluate(board);
-        // Check if current side is winning (eval > 0 for white, eval < 0 for black after negamax flip)
-        isWinning = board.whiteToMove ? (eval > 50) : (eval < -50);
+        // The static eval is from the side to move's point of view
+        int eval = stack[ply].staticEval;
+        isWinning = eval != NO_EVAL && eval > 50;
+    }
+
+    // The quiet move that last refuted the opponent's previous move
+    const Move *counter = nullptr;
+    if (ply >= 1 && !isNullMove(stack[ply - 1].currentMove))
+    {
+        const Move &prev = stack[ply - 1].currentMove;
+        counter = &counterMoves[prev.color][prev.piece][prev.to];
     }
 
     for (auto &m : moves)
@@ -92,36 +291,30 @@ void orderMoves(const Board &board, std::vector<Move> &moves, Move ttBestMove, i
         }
         else if (m.isCapture)
         {
-            m.score = CAPTURE_SCORE_BASE + mvvLvaScore(board, m);
+            Piece victim = capturedPiece(board, m);
+            m.score = CAPTURE_SCORE_BASE + captureScore(m, victim);
 
             // Boost captures in endgame when winning to encourage simplifying trades
             if (isEndgame && isWinning)
-            {
-                auto [capturedPiece, capturedColor] = board.findPiece(m.to);
-
-                if (capturedPiece != PAWN && capturedPiece != NONE)
-                {
-                    m.score += 8000;
-                }
-                else if (capturedPiece == PAWN)
-                {
-                    m.score += 3000;
-                }
-            }
+                m.score += victim == PAWN ? 3000 : 8000;
         }
         else if (m.isPromotion)
         {
             m.score = PROMOTION_SCORE;
         }
-        else if ((ply <= MAX_KILLER_PLY) &&
-                 ((m.from == killerMoves[ply][0].from && m.to == killerMoves[ply][0].to) ||
-                  (m.from == killerMoves[ply][1].from && m.to == killerMoves[ply][1].to)))
+        else if ((ply <= MAX_PLY) &&
+                 ((m.from == stack[ply].killers[0].from && m.to == stack[ply].killers[0].to) ||
+                  (m.from == stack[ply].killers[1].from && m.to == stack[ply].killers[1].to)))
         {
             m.score = KILLER_MOVE_SCORE;
         }
+        else if (counter && m.from == counter->from && m.to == counter->to)
+        {
+            m.score = COUNTER_MOVE_SCORE;
+        }
         else
         {
-            m.score = historyTable[m.piece][m.to];
+            m.score = quietHistory(m, ply);
         }
     }
 
@@ -130,13 +323,78 @@ void orderMoves(const Board &board, std::vector<Move> &moves, Move ttBestMove, i
                      { return a.score > b.score; });
 }
 
-SearchResult Search::think(Board &board)
+// MVV-LVA refined by how often this capture has cut off before
+int SearchWorker::captureScore(const Move &m, Piece victim) const
 {
-    int searchDepth = dynamicDepth(board);
-    return think(board, searchDepth);
+    return 10 * MVV_VALUE[victim] - MVV_VALUE[m.piece] / 10 +
+           captureHistory[m.color][m.piece][m.to][victim] / CAPTURE_HISTORY_DIVISOR;
 }
 
-SearchResult Search::think(Board &board, int maxDepth)
+// Quiet move score: butterfly history plus the continuation histories of
+// the opponent's last move and our own move before it
+int SearchWorker::quietHistory(const Move &m, int ply) const
+{
+    int score = historyTable[m.piece][m.to];
+    for (int back = 1; back <= 2 && back <= ply; ++back)
+    {
+        const Move &prev = stack[ply - back].currentMove;
+        if (!isNullMove(prev))
+            score += continuationHistory[back - 1][m.color][prev.piece][prev.to][m.piece][m.to];
+    }
+    return score;
+}
+
+void SearchWorker::updateQuietHistory(const Move &m, int ply, int bonus)
+{
+    applyHistoryBonus(historyTable[m.piece][m.to], bonus);
+    for (int back = 1; back <= 2 && back <= ply; ++back)
+    {
+        const Move &prev = stack[ply - back].currentMove;
+        if (!isNullMove(prev))
+            applyHistoryBonus(continuationHistory[back - 1][m.color][prev.piece][prev.to][m.piece][m.to], bonus);
+    }
+}
+
+SearchWorker::SearchWorker(TranspositionTable &tt, unsigned int id) : tt(tt), threadId(id)
+{
+}
+
+void SearchWorker::clearHistory()
+{
+    for (auto &entry : stack)
+        entry.killers[0] = entry.killers[1] = Move{};
+    for (auto &byPiece : counterMoves)
+        for (auto &byTo : byPiece)
+            for (auto &m : byTo)
+                m = Move{};
+    std::memset(historyTable, 0, sizeof(historyTable));
+    std::memset(continuationHistory, 0, sizeof(continuationHistory));
+    std::memset(captureHistory, 0, sizeof(captureHistory));
+}
+
+// History from the previous move is still mostly relevant, so it is halved
+// rather than wiped; killers are tied to plies that have shifted and are cleared
+void SearchWorker::ageHistory()
+{
+    for (auto &entry : stack)
+        entry.killers[0] = entry.killers[1] = Move{};
+    for (auto &row : historyTable)
+        for (int &h : row)
+            h /= 2;
+    int16_t *continuation = &continuationHistory[0][0][0][0][0][0];
+    for (size_t i = 0; i < sizeof(continuationHistory) / sizeof(int16_t); ++i)
+        continuation[i] /= 2;
+    int *capture = &captureHistory[0][0][0][0];
+    for (size_t i = 0; i < sizeof(captureHistory) / sizeof(int); ++i)
+        capture[i] /= 2;
+}
+
+SearchContext::SearchContext(TranspositionTable &tt) : tt(tt)
+{
+    setThreads(1);
+}
+
+SearchResult SearchContext::think(Board &board, const SearchLimits &limits)
 {
     if (__builtin_popcountll(board.kings[WHITE]) != 1 ||
         __builtin_popcountll(board.kings[BLACK]) != 1)
@@ -147,22 +405,18 @@ SearchResult Search::think(Board &board, int maxDepth)
         return result;
     }
 
-    std::memset(killerMoves, 0, sizeof(killerMoves));
-    std::memset(historyTable, 0, sizeof(historyTable));
-
-    SearchResult result{};
-    result.nodes = 0;
+    SearchShared shared;
+    shared.limits = limits;
+    shared.start = std::chrono::steady_clock::now();
+    shared.stopped = limits.stop && limits.stop->load();
+    shared.nextInfoMs = INFO_INTERVAL_MS;
 
     std::vector<Move> moves;
     MoveGen::generateLegalMoves(board, moves);
 
-    Move ttBestMove{};
-    TTEntry entry;
-
-    orderMoves(board, moves, ttBestMove, 0);
-
     if (moves.empty())
     {
+        SearchResult result{};
         if (MoveGen::inCheck(board, board.whiteToMove ? WHITE : BLACK))
             result.score = -MATE_SCORE;
         else
@@ -171,48 +425,410 @@ SearchResult Search::think(Board &board, int maxDepth)
         return result;
     }
 
+    // searchmoves: restrict the root, ignoring the list if none of it is legal
+    if (!limits.searchMoves.empty())
+    {
+        std::vector<Move> allowed;
+        for (const auto &m : moves)
+            if (std::any_of(limits.searchMoves.begin(), limits.searchMoves.end(), [&](const Move &s)
+                            { return sameMove(m, s); }))
+                allowed.push_back(m);
+        if (!allowed.empty())
+            moves = std::move(allowed);
+    }
+
+    for (auto &worker : workers)
+        worker->ageHistory();
+
+    // Lazy SMP: helpers search the same root on their own board copies and
+    // share only the TT; the main worker's result is the one reported
+    std::vector<std::thread> helpers;
+    std::vector<uint64_t> helperNodes(workers.size(), 0);
+    for (size_t id = 1; id < workers.size(); ++id)
+    {
+        helpers.emplace_back([&, id, boardCopy = board]() mutable
+                             { helperNodes[id] = workers[id]->iterativeDeepening(boardCopy, moves, shared).nodes; });
+    }
+
+    SearchResult result = workers[0]->iterativeDeepening(board, moves, shared);
+
+    shared.stopped = true;
+    for (auto &t : helpers)
+        t.join();
+    for (uint64_t n : helperNodes)
+        result.nodes += n;
+
+    return result;
+}
+
+void SearchContext::setThreads(unsigned int threads)
+{
+    threads = std::max(1u, threads);
+    while (workers.size() > threads)
+        workers.pop_back();
+    while (workers.size() < threads)
+        workers.push_back(std::make_unique<SearchWorker>(tt, static_cast<unsigned int>(workers.size())));
+}
+
+unsigned int SearchContext::getThreads() const
+{
+    return static_cast<unsigned int>(workers.size());
+}
+
+void SearchContext::newGame()
+{
+    for (auto &worker : workers)
+        worker->clearHistory();
+    tt.clear();
+}
+
+Move SearchContext::ponderMove(Board &board, const Move &bestMove) const
+{
+    Move reply{};
+    MoveState st;
+    MoveGen::makeMove(board, bestMove, st);
+
+    TTEntry entry;
+    if (tt.probe(board.hash, entry))
+    {
+        // The TT move is only a hint, so match it against the legal replies
+        std::vector<Move> moves;
+        MoveGen::generateLegalMoves(board, moves);
+        for (const auto &m : moves)
+        {
+            if (sameMove(m, entry.bestMove))
+            {
+                reply = m;
+                break;
+            }
+        }
+    }
+
+    MoveGen::unmakeMove(board, bestMove, st);
+    return reply;
+}
+
+SearchContext &Search::context()
+{
+    static TranspositionTable tt;
+    static SearchContext context(tt);
+    return context;
+}
+
+SearchResult Search::think(Board &board)
+{
+    int searchDepth = dynamicDepth(board);
+    return think(board, searchDepth);
+}
+
+SearchResult Search::think(Board &board, int maxDepth)
+{
+    SearchLimits limits;
+    limits.depth = maxDepth;
+    return think(board, limits);
+}
+
+SearchResult Search::think(Board &board, const SearchLimits &limits)
+{
+    return context().think(board, limits);
+}
+
+void Search::setThreads(unsigned int threads)
+{
+    context().setThreads(threads);
+}
+
+unsigned int Search::getThreads()
+{
+    return context().getThreads();
+}
+
+Move Search::ponderMove(Board &board, const Move &bestMove)
+{
+    return context().ponderMove(board, bestMove);
+}
+
+void Search::newGame()
+{
+    context().newGame();
+}
+
+SearchResult SearchWorker::iterativeDeepening(Board &board, std::vector<Move> moves, SearchShared &sharedState)
+{
+    shared = &sharedState;
+    nodes = 0;
+
+    SearchResult result{};
+    result.nodes = 0;
+
+    // Helpers are perturbed so they don't duplicate the main thread's tree: odd
+    // helpers run one ply ahead and each helper rotates the root moves behind
+    // the best one by its id. Only the main thread searches several lines.
+    const bool helper = threadId != 0;
+    const int lineCount = helper ? 1 : std::clamp(shared->limits.multiPV, 1, static_cast<int>(moves.size()));
+    int maxDepth = shared->limits.depth > 0 ? std::min(shared->limits.depth, MAX_SEARCH_DEPTH) : MAX_SEARCH_DEPTH;
+    if (shared->limits.mate > 0)
+        maxDepth = std::min(maxDepth, 2 * shared->limits.mate - 1);
+    int stableIterations = 0; // consecutive iterations with the same best move
+
+    // The root entry is fixed for the whole search; negamax fills in the plies below it
+    stack[0].inCheck = MoveGen::inCheck(board, board.whiteToMove ? WHITE : BLACK);
+    stack[0].staticEval = stack[0].inCheck ? NO_EVAL : evaluate(board);
+    stack[0].excludedMove = Move{};
+    stack[0].evalReady = false;
+
+    // A TT hit from an earlier search seeds the first iteration's ordering
+    std::vector<PVLine> previousLines(1);
+    TTEntry entry;
+    if (tt.probe(board.hash, entry))
+        previousLines[0].move = entry.bestMove;
+
+    for (int depth = 1 + (threadId & 1); depth <= maxDepth; ++depth)
+    {
+        std::vector<PVLine> lines;
+        int researches = 0;
+        rootDepth = depth;
+        selDepth = 0;
+
+        for (int pvIdx = 0; pvIdx < lineCount; ++pvIdx)
+        {
+            // Each line searches the root moves not already taken by a better line
+            std::vector<Move> candidates;
+            for (const auto &m : moves)
+            {
+                bool reported = std::any_of(lines.begin(), lines.end(), [&](const PVLine &line)
+                                            { return sameMove(line.move, m); });
+                if (!reported)
+                    candidates.push_back(m);
+            }
+
+            Move rootHint = pvIdx < static_cast<int>(previousLines.size()) ? previousLines[pvIdx].move : Move{};
+            int previousScore = pvIdx < static_cast<int>(previousLines.size()) ? previousLines[pvIdx].score : 0;
+
+            // Open with a narrow window around the previous score and widen it
+            // geometrically on the side that failed
+            int delta = ASPIRATION_DELTA;
+            int alpha = -INF;
+            int beta = INF;
+            if (depth >= ASPIRATION_MIN_DEPTH && result.depth > 0 && std::abs(previousScore) < MATE_SCORE - MAX_PLY)
+            {
+                alpha = std::max(previousScore - delta, -INF);
+                beta = std::min(previousScore + delta, INF);
+            }
+
+            Move lineBest{};
+            int score;
+
+            while (true)
+            {
+                orderMoves(board, candidates, rootHint, 0);
+                if (helper && candidates.size() > 2)
+                    std::rotate(candidates.begin() + 1, candidates.begin() + 1 + threadId % (candidates.size() - 1),
+                                candidates.end());
+                score = searchRoot(board, candidates, depth, alpha, beta, lineBest, pvIdx == 0);
+
+                if (shared->stopped)
+                    break;
+
+                if (score <= alpha)
+                {
+                    alpha = std::max(alpha - delta, -INF);
+                    result.aspirationFailLows++;
+                }
+                else if (score >= beta)
+                {
+                    beta = std::min(beta + delta, INF);
+                    rootHint = lineBest;
+                    result.aspirationFailHighs++;
+                }
+                else
+                {
+                    break;
+                }
+
+                researches++;
+                delta *= 2;
+                if (delta > ASPIRATION_MAX_DELTA)
+                {
+                    alpha = -INF;
+                    beta = INF;
+                }
+            }
+
+            // Keep the first line's ordering so equally scored moves stay in
+            // the order earlier iterations left them
+            if (pvIdx == 0)
+                moves = candidates;
+
+            // A partial first line is still better than nothing on the first iteration
+            if (shared->stopped && (pvIdx > 0 || result.depth > 0))
+                break;
+
+            std::vector<Move> pv(pvTable[0], pvTable[0] + pvLength[0]);
+            if (pv.empty() || !sameMove(pv.front(), lineBest))
+                pv.assign(1, lineBest);
+            lines.push_back({lineBest, score, pv});
+
+            if (!helper && shared->limits.info && !shared->stopped)
+            {
+                SearchInfo info =
+                    makeInfo(shared->nodes.load(std::memory_order_relaxed) +
+                             (nodes & (publishInterval(shared->limits) - 1)));
+                info.multiPV = pvIdx + 1;
+                info.score = score;
+                if (std::abs(score) > MATE_SCORE - MAX_PLY)
+                    info.mateIn = score > 0 ? (MATE_SCORE - score + 1) / 2 : -(MATE_SCORE + score) / 2;
+                info.pv = pv;
+                shared->limits.info(info);
+                shared->nextInfoMs = info.timeMs + INFO_INTERVAL_MS;
+            }
+        }
+
+        // An interrupted iteration is discarded unless it is the only one we have
+        if (shared->stopped && result.depth > 0)
+            break;
+
+        const Move iterationBest = lines.front().move;
+        const int score = lines.front().score;
+        int scoreDrop = result.depth > 0 ? result.score - score : 0;
+        stableIterations = result.depth > 0 && sameMove(iterationBest, result.bestMove) ? stableIterations + 1 : 0;
+
+        result.bestMove = iterationBest;
+        result.score = score;
+        result.depth = depth;
+        result.selDepth = selDepth;
+        result.timeMs = shared->elapsedMs();
+        result.pv = lines.front().pv;
+        result.iterations.push_back(
+            {depth, score, iterationBest, nodes, researches, selDepth, result.timeMs, result.pv});
+        result.lines = lines;
+        previousLines = lines;
+
+        if (shared->stopped)
+            break;
+
+        // A full-width iteration that finds a mate already found the shortest
+        // one; with several lines the others may still improve
+        if (lineCount == 1 && std::abs(score) > MATE_SCORE - MAX_PLY)
+            break;
+
+        // Only the main thread decides when to stop; helpers follow shared->stopped
+        if (!helper && shared->limits.softTimeMs && !shared->pondering() &&
+            shared->elapsedMs() >= TimeManager::adjustSoftLimit(shared->limits.softTimeMs, shared->limits.timeMs,
+                                                        stableIterations, scoreDrop))
+            break;
+    }
+
+    result.nodes = nodes;
+    return result;
+}
+
+int SearchWorker::searchRoot(Board &board, std::vector<Move> &moves, int depth, int alpha, int beta,
+                             Move &bestMoveOut, bool storeTT)
+{
     int bestScore = -INF;
-    Move bestMove{};
-    uint64_t totalNodes = 0;
-    int alpha = -INF;
-    int beta = INF;
+    int alphaOrig = alpha;
+    bestMoveOut = moves.front();
+    pvLength[0] = 0;
 
+    bool first = true;
     for (auto &m : moves)
     {
         MoveState st;
         MoveGen::makeMove(board, m, st);
+        stack[0].currentMove = m;
 
-        uint64_t localNodes = 0;
         Move dummy;
-
-        int score = -negamax(board, maxDepth - 1, -beta, -alpha, localNodes, dummy, 1);
+        int score;
+        pvLength[1] = 1; // a scout that is never re-searched leaves no PV
+        if (first)
+        {
+            score = -negamax<SearchNode::PV>(board, depth - 1, -beta, -alpha, dummy, 1);
+            first = false;
+        }
+        else
+        {
+            score = -negamax<SearchNode::NonPV>(board, depth - 1, -alpha - 1, -alpha, dummy, 1);
+            if (score > alpha && score < beta)
+                score = -negamax<SearchNode::PV>(board, depth - 1, -beta, -alpha, dummy, 1);
+        }
 
         MoveGen::unmakeMove(board, m, st);
-        totalNodes += localNodes;
+
+        if (shared->stopped)
+            break;
 
         if (score > bestScore)
         {
             bestScore = score;
-            bestMove = m;
+            bestMoveOut = m;
+            updatePV(0, m);
         }
 
         if (score > alpha)
             alpha = score;
+
+        if (alpha >= beta)
+            break;
     }
 
-    result.bestMove = bestMove;
-    result.score = bestScore;
-    result.nodes = totalNodes;
-    return result;
+    // Lines that exclude root moves must not overwrite the real root entry
+    if (!shared->stopped && storeTT)
+    {
+        NodeType type = NodeType::EXACT;
+        if (bestScore <= alphaOrig)
+            type = NodeType::UPPERBOUND;
+        else if (bestScore >= beta)
+            type = NodeType::LOWERBOUND;
+        tt.store(board.hash, depth, bestScore, type, bestMoveOut);
+    }
+
+    return bestScore;
 }
 
-int Search::quiescence(Board &board, int alpha, int beta, uint64_t &nodes)
+// staticEval is the caller's evaluation of this position, or NO_EVAL
+int SearchWorker::quiescence(Board &board, int alpha, int beta, int ply, int staticEval)
 {
+    selDepth = std::max(selDepth, ply);
+    // Re-searches after a stop must not count nodes past the budget
+    if (shared->stopped)
+        return 0;
     nodes++;
-    int standPat = evaluate(board);
+    if (shouldStop())
+        return 0;
+
+    const bool pvNode = beta - alpha > 1;
+
+    // Any entry is at least as deep as qsearch, so off the PV its bound is trusted
+    TTEntry entry;
+    Move ttBestMove{};
+    if (tt.probe(board.hash, entry))
+    {
+        ttBestMove = entry.bestMove;
+        int score = scoreFromTT(entry.score, ply);
+        if (!pvNode && entry.depth >= QS_TT_DEPTH &&
+            (entry.type == NodeType::EXACT ||
+             (entry.type == NodeType::LOWERBOUND && score >= beta) ||
+             (entry.type == NodeType::UPPERBOUND && score <= alpha)))
+            return std::clamp(score, alpha, beta);
+    }
+
+    int standPat = staticEval != NO_EVAL ? staticEval : evaluate(board);
 
     if (standPat >= beta)
+    {
+        tt.store(board.hash, QS_TT_DEPTH, scoreToTT(beta, ply), NodeType::LOWERBOUND, Move{});
         return beta;
+    }
+
+    // Delta pruning: not even winning a queen brings the score back to alpha.
+    // A pawn about to promote can also turn itself into a queen.
+    uint64_t promotingPawns = board.whiteToMove ? board.pawns[WHITE] & RANK_7 : board.pawns[BLACK] & RANK_2;
+    int maxGain = MVV_VALUE[QUEEN] + (promotingPawns ? MVV_VALUE[QUEEN] - MVV_VALUE[PAWN] : 0);
+    if (standPat + maxGain + DELTA_MARGIN <= alpha)
+        return alpha;
+
+    int alphaOrig = alpha;
     if (standPat > alpha)
         alpha = standPat;
 
@@ -224,10 +840,21 @@ int Search::quiescence(Board &board, int alpha, int beta, uint64_t &nodes)
     {
         if (moves[i].isCapture || moves[i].isPromotion)
         {
-            if (moves[i].isCapture)
-                moves[i].score = mvvLvaScore(board, moves[i]);
+            Move &m = moves[i];
+            Piece victim = m.isCapture ? capturedPiece(board, m) : NONE;
+
+            // Delta pruning per move: the material won plus a margin cannot reach alpha
+            int gain = (victim != NONE ? MVV_VALUE[victim] : 0) +
+                       (m.isPromotion ? MVV_VALUE[m.piece] - MVV_VALUE[PAWN] : 0);
+            if (standPat + gain + DELTA_MARGIN <= alpha)
+                continue;
+
+            if (sameMove(m, ttBestMove))
+                m.score = TT_MOVE_SCORE;
+            else if (victim != NONE)
+                m.score = captureScore(m, victim);
             else
-                moves[i].score = 50000;
+                m.score = 50000;
 
             if (i != captureStart)
                 std::swap(moves[i], moves[captureStart]);
@@ -239,31 +866,64 @@ int Search::quiescence(Board &board, int alpha, int beta, uint64_t &nodes)
                      [](const Move &a, const Move &b)
                      { return a.score > b.score; });
 
+    Move bestMove{};
     for (size_t i = 0; i < captureStart; ++i)
     {
         MoveState st;
         MoveGen::makeMove(board, moves[i], st);
-        int evalScore = -quiescence(board, -beta, -alpha, nodes);
+        int evalScore = -quiescence(board, -beta, -alpha, ply + 1, NO_EVAL);
         MoveGen::unmakeMove(board, moves[i], st);
 
+        if (shared->stopped)
+            return 0;
+
         if (evalScore >= beta)
+        {
+            tt.store(board.hash, QS_TT_DEPTH, scoreToTT(beta, ply), NodeType::LOWERBOUND, moves[i]);
             return beta;
+        }
         if (evalScore > alpha)
+        {
             alpha = evalScore;
+            bestMove = moves[i];
+        }
     }
 
+    NodeType type = alpha > alphaOrig ? NodeType::EXACT : NodeType::UPPERBOUND;
+    tt.store(board.hash, QS_TT_DEPTH, scoreToTT(alpha, ply), type, bestMove);
     return alpha;
 }
 
-int Search::negamax(Board &board, int depth, int alpha, int beta,
-                    uint64_t &nodes, Move &bestMoveOut, int ply)
+// Computes this ply's check flag and static eval, unless a same-ply re-search
+// (null-move verification, singular exclusion) is reusing the caller's
+void SearchWorker::fillStackEntry(Board &board, int ply)
+{
+    StackEntry &entry = stack[ply];
+    if (entry.evalReady)
+        return;
+    entry.inCheck = MoveGen::inCheck(board, board.whiteToMove ? WHITE : BLACK);
+    entry.staticEval = entry.inCheck ? NO_EVAL : evaluate(board);
+}
+
+template <SearchNode Node>
+int SearchWorker::negamax(Board &board, int depth, int alpha, int beta,
+                          Move &bestMoveOut, int ply, bool allowNull)
 {
     assert(ply >= 0 && ply <= MAX_PLY);
+    constexpr bool pvNode = Node == SearchNode::PV;
+    if (pvNode)
+        pvLength[ply] = ply;
+    selDepth = std::max(selDepth, ply);
+    if (shared->stopped)
+        return 0;
     nodes++;
+    if (shouldStop())
+        return 0;
 
     if (board.isDraw())
     {
-        int eval = evaluate(board);
+        fillStackEntry(board, ply);
+        int eval = stack[ply].inCheck ? evaluate(board) : stack[ply].staticEval;
 
         // Apply penalty/bonus based on evaluation
         // When winning, heavily penalize to avoid repetition
@@ -283,41 +943,174 @@ int Search::negamax(Board &board, int depth, int alpha, int beta,
         }
     }
 
+    // Mate-distance pruning: no line from here can beat a mate found nearer the root
+    alpha = std::max(alpha, -MATE_SCORE + ply);
+    beta = std::min(beta, MATE_SCORE - ply - 1);
+    if (alpha >= beta)
+        return alpha;
+
+    // Singular extension verification searches this node again without the TT move;
+    // the TT entry describes the full node, so it is neither trusted nor overwritten
+    const Move excludedMove = stack[ply].excludedMove;
+    const bool excluding = !isNullMove(excludedMove);
+
     uint64_t hash = board.hash;
     TTEntry entry;
     Move ttBestMove{};
+    bool ttHit = tt.probe(hash, entry);
 
-    if (TT.probe(hash, entry))
+    if (ttHit)
     {
         ttBestMove = entry.bestMove;
-        if (entry.depth >= depth)
+        entry.score = scoreFromTT(entry.score, ply);
+        // Bounds from the TT are only trusted off the PV so the PV stays searched
+        if (!pvNode && !excluding && entry.depth >= depth)
         {
             int score = entry.score;
+            switch (entry.type)
+            {
+            case NodeType::EXACT:
+                bestMoveOut = entry.bestMove;
+                return score;
+            case NodeType::LOWERBOUND:
+                alpha = std::max(alpha, score);
+                break;
+            case NodeType::UPPERBOUND:
+                beta = std::min(beta, score);
+                break;
+            }
+            if (alpha >= beta)
+                return score;
+        }
+    }
+
+    Color us = board.whiteToMove ? WHITE : BLACK;
+    fillStackEntry(board, ply);
+    const bool inCheck = stack[ply].inCheck;
+    const int staticEval = stack[ply].staticEval;
 
-            bool isMateScore = std::abs(score) > MATE_SCORE - MAX_PLY;
-            bool skipMateScore = isMateScore && entry.depth != depth;
+    // Improving: our eval rose since our previous move two plies ago
+    bool improving = !inCheck && ply >= 2 && !stack[ply - 2].inCheck &&
+                     staticEval > stack[ply - 2].staticEval;
+
+    // Shallow-depth pruning relies on the static eval, so it is off in check,
+    // on the PV and whenever a mate score bounds the window
+    bool canPruneShallow = !pvNode && !inCheck &&
+                           std::abs(alpha) < MATE_SCORE - MAX_PLY &&
+                           std::abs(beta) < MATE_SCORE - MAX_PLY;
+
+    // Reverse futility pruning: far enough above beta that no reply will bring it back
+    if (canPruneShallow && depth >= 1 && depth <= RFP_MAX_DEPTH &&
+        staticEval - RFP_MARGIN * depth >= beta)
+    {
+        return staticEval;
+    }
+
+    // Razoring: far below alpha, only tactics can help, so let qsearch decide
+    if (canPruneShallow && depth >= 1 && depth <= RAZOR_MAX_DEPTH &&
+        staticEval + RAZOR_MARGIN[depth] < alpha)
+    {
+        int razorScore = quiescence(board, alpha, alpha + 1, ply, staticEval);
+        if (shared->stopped)
+            return 0;
+        if (razorScore <= alpha)
+            return razorScore;
+    }
 
-            // Only use TT entry if it's not a mate score from a different depth
-            if (!skipMateScore)
+    // Null-move pruning: if passing still fails high, a real move will too.
+    // Skipped without non-pawn material, where zugzwang makes passing unsound,
+    // and verified by a reduced normal search at high depth.
+    if (!pvNode && allowNull && !excluding && !inCheck && depth >= NULL_MOVE_MIN_DEPTH &&
+        std::abs(beta) < MATE_SCORE - MAX_PLY && hasNonPawnMaterial(board, us) &&
+        staticEval >= beta)
+    {
+        int R = NULL_MOVE_BASE_REDUCTION + depth / NULL_MOVE_DEPTH_DIVISOR;
+        int nullDepth = std::max(0, depth - 1 - R);
+
+        MoveState nullState;
+        Move childBest{};
+        MoveGen::makeNullMove(board, nullState);
+        stack[ply].currentMove = Move{};
+        int nullScore = -negamax<SearchNode::NonPV>(board, nullDepth, -beta, -beta + 1, childBest, ply + 1, false);
+        MoveGen::unmakeNullMove(board, nullState);
+
+        if (shared->stopped)
+            return 0;
+
+        if (nullScore >= beta)
+        {
+            // Never return an unproven mate from a null-move search
+            if (nullScore >= MATE_SCORE - MAX_PLY)
+                nullScore = beta;
+
+            if (depth < NULL_MOVE_VERIFY_DEPTH)
+                return nullScore;
+
+            stack[ply].evalReady = true;
+            int verified = negamax<SearchNode::NonPV>(board, nullDepth, beta - 1, beta, childBest, ply, false);
+            stack[ply].evalReady = false;
+            if (shared->stopped)
+                return 0;
+            if (verified >= beta)
+                return nullScore;
+        }
+    }
+
+    // ProbCut: a capture that beats beta by a margin in a reduced search would
+    // almost certainly beat beta at full depth too
+    int probCutBeta = beta + PROBCUT_MARGIN;
+    if (!pvNode && !excluding && !inCheck && depth >= PROBCUT_MIN_DEPTH &&
+        std::abs(beta) < MATE_SCORE - MAX_PLY &&
+        !(ttHit && entry.depth >= depth - PROBCUT_REDUCTION && entry.score < probCutBeta))
+    {
+        std::vector<Move> captures;
+        MoveGen::generateLegalMoves(board, captures);
+        captures.erase(std::remove_if(captures.begin(), captures.end(), [&](Move &m)
+                                      {
+                                          if (!m.isCapture)
+                                              return true;
+                                          // Only captures whose material gain could plausibly reach probCutBeta
+                                          Piece victim = capturedPiece(board, m);
+                                          m.score = captureScore(m, victim);
+                                          return staticEval + MVV_VALUE[victim] < probCutBeta; }),
+                       captures.end());
+        std::stable_sort(captures.begin(), captures.end(),
+                         [](const Move &a, const Move &b)
+                         { return a.score > b.score; });
+
+        for (const auto &m : captures)
+        {
+            MoveState st;
+            MoveGen::makeMove(board, m, st);
+            stack[ply].currentMove = m;
+
+            // Qsearch first: most captures fail it and skip the reduced search
+            int score = -quiescence(board, -probCutBeta, -probCutBeta + 1, ply + 1, NO_EVAL);
+            if (score >= probCutBeta)
             {
-                switch (entry.type)
-                {
-                case NodeType::EXACT:
-                    bestMoveOut = entry.bestMove;
-                    return score;
-                case NodeType::LOWERBOUND:
-                    alpha = std::max(alpha, score);
-                    break;
-                case NodeType::UPPERBOUND:
-                    beta = std::min(beta, score);
-                    break;
-                }
-                if (alpha >= beta)
-                    return score;
+                Move childBest{};
+                score = -negamax<SearchNode::NonPV>(board, depth - PROBCUT_REDUCTION, -probCutBeta,
+                                                    -probCutBeta + 1, childBest, ply + 1);
+            }
+            MoveGen::unmakeMove(board, m, st);
+
+            if (shared->stopped)
+                return 0;
+
+            if (score >= probCutBeta)
+            {
+                tt.store(hash, depth - PROBCUT_REDUCTION + 1, scoreToTT(score, ply), NodeType::LOWERBOUND, m);
+                bestMoveOut = m;
+                return score;
             }
         }
     }
 
+    // Internal iterative reduction: without a TT move the first move searched is
+    // a guess, so search shallower; the next iteration returns with a hash move
+    if (depth >= IIR_MIN_DEPTH && !excluding && isNullMove(ttBestMove))
+        depth--;
+
     int alphaOrig = alpha;
     int betaOrig = beta;
 
@@ -326,13 +1119,12 @@ int Search::negamax(Board &board, int depth, int alpha, int beta,
 
     if (moves.empty())
     {
-        bool inCheck = MoveGen::inCheck(board, board.whiteToMove ? WHITE : BLACK);
         return inCheck ? -MATE_SCORE + ply : 0;
     }
 
     if (depth == 0)
     {
-        return quiescence(board, alpha, beta, nodes);
+        return quiescence(board, alpha, beta, ply, staticEval);
     }
 
     orderMoves(board, moves, ttBestMove, ply);
@@ -342,78 +1134,192 @@ int Search::negamax(Board &board, int depth, int alpha, int beta,
     MoveState state;
     int movesSearched = 0;
 
+    // Futility pruning: quiet moves cannot lift a hopeless static eval over alpha
+    bool futile = canPruneShallow && depth <= FUTILITY_MAX_DEPTH &&
+                  staticEval + FUTILITY_MARGIN[depth] <= alpha;
+
+    // Late move pruning: past this many quiet moves the rest are skipped
+    int lmpLimit = (3 + depth * depth) / (improving ? 1 : 2);
+    int quietsSearched = 0;
+    Move quietsTried[64]; // penalised if a later quiet move cuts off
+    int capturesSearched = 0;
+    Move capturesTried[32]; // penalised if any later move cuts off
+
+    // Singular extension candidate: a trusted TT move whose score may stand alone
+    bool trySingular = !excluding && ply > 0 && depth >= SINGULAR_MIN_DEPTH && ttHit &&
+                       entry.depth >= depth - 3 && entry.type != NodeType::UPPERBOUND &&
+                       std::abs(entry.score) < MATE_SCORE - MAX_PLY;
+
+    // Extensions are capped by ply so forcing lines cannot grow without bound
+    bool canExtend = ply < std::min(2 * rootDepth, MAX_PLY / 2);
+
     for (auto &m : moves)
     {
+        if (excluding && sameMove(m, excludedMove))
+            continue;
+
+        bool isQuiet = !m.isCapture && !m.isPromotion;
+        int extension = 0;
+
+        // Singular extension: if every other move fails well below the TT score at
+        // reduced depth, the TT move is the only good one and gets an extra ply
+        if (trySingular && canExtend && sameMove(m, ttBestMove))
+        {
+            int singularBeta = entry.score - SINGULAR_MARGIN * depth;
+            int singularDepth = (depth - 1) / 2;
+            Move childBest{};
+            stack[ply].excludedMove = m;
+            stack[ply].evalReady = true;
+            int singularScore = negamax<SearchNode::NonPV>(board, singularDepth, singularBeta - 1, singularBeta,
+                                                           childBest, ply, false);
+            stack[ply].excludedMove = Move{};
+            stack[ply].evalReady = false;
+            if (shared->stopped)
+                return 0;
+
+            if (singularScore < singularBeta)
+                extension = 1;
+            else if (singularBeta >= beta)
+                return singularBeta; // multi-cut: several moves beat beta
+        }
+
         MoveGen::makeMove(board, m, state);
+        stack[ply].currentMove = m;
+        if (pvNode)
+            pvLength[ply + 1] = ply + 1; // a scout that is never re-searched leaves no PV
+        bool givesCheck = MoveGen::inCheck(board, board.whiteToMove ? WHITE : BLACK);
+
+        // Check extension: don't let a forcing line drop into qsearch mid-attack
+        if (givesCheck && canExtend)
+            extension = 1;
+
+        int newDepth = depth - 1 + extension;
+
+        if (movesSearched > 0 && isQuiet && !givesCheck &&
+            (futile || (canPruneShallow && depth <= LMP_MAX_DEPTH && quietsSearched >= lmpLimit)))
+        {
+            MoveGen::unmakeMove(board, m, state);
+            continue;
+        }
+
         Move childBest{};
         int score;
         movesSearched++;
-
-        bool reduce = false;
-        int reduction = 0;
-        if (depth >= 3 && movesSearched > 4 && !m.isCapture && !m.isPromotion && !MoveGen::inCheck(board, board.whiteToMove ? WHITE : BLACK))
+        if (isQuiet)
         {
-            reduce = true;
-            reduction = 1 + (movesSearched > 8 ? 1 : 0);
+            if (quietsSearched < 64)
+                quietsTried[quietsSearched] = m;
+            quietsSearched++;
+        }
+        else if (m.isCapture)
+        {
+            if (capturesSearched < 32)
+                capturesTried[capturesSearched] = m;
+            capturesSearched++;
         }
 
-        if (reduce)
+        if (movesSearched == 1)
         {
-            score = -negamax(board, depth - 1 - reduction, -alpha - 1, -alpha, nodes, childBest, ply + 1);
-            if (score > alpha)
-            {
-                score = -negamax(board, depth - 1, -beta, -alpha, nodes, childBest, ply + 1);
-            }
+            // First move: full window, it is expected to be the best
+            score = -negamax<Node>(board, newDepth, -beta, -alpha, childBest, ply + 1);
         }
         else
         {
-            score = -negamax(board, depth - 1, -beta, -alpha, nodes, childBest, ply + 1);
+            int reduction = 0;
+            if (depth >= LMR_MIN_DEPTH && movesSearched >= LMR_MIN_MOVES && isQuiet && !givesCheck && !inCheck &&
+                extension == 0)
+            {
+                reduction = lmrReduction(depth, movesSearched);
+                if (pvNode)
+                    reduction--;
+                if (!improving)
+                    reduction++;
+                if (m.score == KILLER_MOVE_SCORE || m.score == COUNTER_MOVE_SCORE)
+                    reduction--;
+                reduction -= std::clamp(quietHistory(m, ply) / LMR_HISTORY_DIVISOR, -2, 2);
+
+                // Always leave at least one ply for the reduced search
+                reduction = std::clamp(reduction, 0, newDepth - 1);
+            }
+
+            // Later moves: zero window scout, only re-searched when they beat alpha
+            score = -negamax<SearchNode::NonPV>(board, newDepth - reduction, -alpha - 1, -alpha, childBest, ply + 1);
+            if (score > alpha && reduction > 0)
+            {
+                score = -negamax<SearchNode::NonPV>(board, newDepth, -alpha - 1, -alpha, childBest, ply + 1);
+            }
+            if (pvNode && score > alpha && score < beta)
+            {
+                score = -negamax<SearchNode::PV>(board, newDepth, -beta, -alpha, childBest, ply + 1);
+            }
         }
 
         MoveGen::unmakeMove(board, m, state);
 
+        if (shared->stopped)
+            return 0;
+
         if (score > bestScore)
         {
             bestScore = score;
             bestMoveLocal = m;
         }
 
+        if (pvNode && score > alpha)
+            updatePV(ply, m);
+
         if (bestScore > alpha)
             alpha = bestScore;
 
         if (alpha >= beta)
         {
-            if (!m.isCapture && !m.isPromotion && ply <= MAX_KILLER_PLY)
+            int bonus = historyBonus(depth);
+            if (isQuiet)
             {
-                if (killerMoves[ply][0].from != m.from || killerMoves[ply][0].to != m.to)
+                if (stack[ply].killers[0].from != m.from || stack[ply].killers[0].to != m.to)
                 {
-                    killerMoves[ply][1] = killerMoves[ply][0];
-                    killerMoves[ply][0] = m;
+                    stack[ply].killers[1] = stack[ply].killers[0];
+                    stack[ply].killers[0] = m;
                 }
-                int increment = depth * depth;
-                if (historyTable[m.piece][m.to] < HISTORY_MAX - increment)
+                if (ply >= 1 && !isNullMove(stack[ply - 1].currentMove))
                 {
-                    historyTable[m.piece][m.to] += increment;
-                }
-                else
-                {
-                    for (int i = 0; i < 6; ++i)
-                        for (int j = 0; j < 64; ++j)
-                            historyTable[i][j] /= 2;
-                    historyTable[m.piece][m.to] = increment;
+                    const Move &prev = stack[ply - 1].currentMove;
+                    counterMoves[prev.color][prev.piece][prev.to] = m;
                 }
+
+                // Reward the cutoff move, penalise the quiets searched before it
+                updateQuietHistory(m, ply, bonus);
+                for (int i = 0; i < std::min(quietsSearched - 1, 64); ++i)
+                    updateQuietHistory(quietsTried[i], ply, -bonus);
+            }
+            else if (m.isCapture)
+            {
+                applyHistoryBonus(captureHistory[m.color][m.piece][m.to][capturedPiece(board, m)], bonus);
+            }
+
+            // Captures searched before the cutoff move failed to refute
+            int failedCaptures = std::min(capturesSearched - (m.isCapture ? 1 : 0), 32);
+            for (int i = 0; i < failedCaptures; ++i)
+            {
+                const Move &c = capturesTried[i];
+                applyHistoryBonus(captureHistory[c.color][c.piece][c.to][capturedPiece(board, c)], -bonus);
             }
             break;
         }
     }
 
+    // Only the excluded move was legal: report a fail-low, not a mate
+    if (movesSearched == 0)
+        return alpha;
+
     NodeType type = NodeType::EXACT;
     if (bestScore <= alphaOrig)
         type = NodeType::UPPERBOUND;
     else if (bestScore >= betaOrig)
         type = NodeType::LOWERBOUND;
 
-    TT.store(hash, depth, bestScore, type, bestMoveLocal);
+    if (!excluding)
+        tt.store(hash, depth, scoreToTT(bestScore, ply), type, bestMoveLocal);
 
     bestMoveOut = bestMoveLocal;
     return bestScore;
@@ -2,23 +2,189 @@
 #include "board/Board.h"
 #include "board/MoveGen.h"
 #include "engine/Evaluation.h"
+#include "engine/Transposition.h"
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <vector>
 
+// A completed line, or a progress report during a long iteration (empty pv)
+struct SearchInfo
+{
+    int depth = 0;
+    int selDepth = 0;
+    int multiPV = 1; // 1-based line number
+    int score = 0;
+    int mateIn = 0;  // moves to mate, negative when getting mated, 0 if score is not a mate
+    std::vector<Move> pv;
+    uint64_t nodes = 0; // all threads, approximate with several threads
+    uint64_t nps = 0;
+    int hashfull = 0; // permille
+    int64_t timeMs = 0;
+};
+
+struct SearchLimits
+{
+    int depth = 0;       // 0 = no depth limit
+    uint64_t nodes = 0;  // 0 = no node limit
+    int64_t timeMs = 0;  // 0 = no time limit; aborts mid-iteration
+    int64_t softTimeMs = 0; // 0 = none; no new iteration once exceeded (scaled by stability)
+    const std::atomic<bool> *stop = nullptr; // set by another thread to abort the search
+    const std::atomic<bool> *ponder = nullptr; // time limits are suspended while this is set
+    int multiPV = 1;                         // best lines to search, each excluding the earlier ones
+    int mate = 0;                            // 0 = none; look for a mate in this many moves, at most
+                                             // 2 * mate - 1 plies deep
+    std::vector<Move> searchMoves;           // root moves to consider, empty = all legal moves
+    std::function<void(const SearchInfo &)> info; // main thread: every completed line, and progress
+                                                  // about once a second
+};
+
+struct IterationResult
+{
+    int depth = 0;
+    int score = 0;
+    Move bestMove{};
+    uint64_t nodes = 0; // cumulative nodes at the end of the iteration
+    int researches = 0; // aspiration window re-searches in this iteration
+    int selDepth = 0;
+    int64_t timeMs = 0;
+    std::vector<Move> pv;
+};
+
+struct PVLine
+{
+    Move move{};
+    int score = 0;
+    std::vector<Move> pv;
+};
+
 struct SearchResult
 {
     Move bestMove{};
     int score = 0;
     uint64_t nodes = 0;
+    int depth = 0;                           // last completed iteration
+    int selDepth = 0;
+    int64_t timeMs = 0;
+    std::vector<Move> pv;                    // principal variation, starting with bestMove
+    std::vector<IterationResult> iterations; // one entry per completed iteration
+    int aspirationFailLows = 0;
+    int aspirationFailHighs = 0;
+    std::vector<PVLine> lines; // MultiPV lines of the last completed iteration, best first
+};
+
+// State shared by every worker of one search
+struct SearchShared
+{
+    SearchLimits limits;
+    std::chrono::steady_clock::time_point start;
+    std::atomic<bool> stopped{false};
+    std::atomic<uint64_t> nodes{0}; // all workers, published in steps of the limit check interval
+    int64_t nextInfoMs = 0;         // next progress report, main worker only
+
+    int64_t elapsedMs() const;
+    bool pondering() const;
+    bool limitReached(uint64_t totalNodes) const;
+};
+
+// Node type negamax is compiled for. PV nodes search with an open window and
+// keep the PV table; NonPV nodes are null-window scouts, the bulk of the tree.
+// The root is handled by SearchWorker::searchRoot.
+enum class SearchNode
+{
+    PV,
+    NonPV
+};
+
+// One search thread. Owns its move-ordering heuristics, per-ply stacks and
+// node counter; the TT and the stop/limit state are reached by reference.
+class SearchWorker
+{
+public:
+    static constexpr int MAX_PLY = 127;
+
+    SearchWorker(TranspositionTable &tt, unsigned int id);
+
+    SearchResult iterativeDeepening(Board &board, std::vector<Move> moves, SearchShared &shared);
+    void clearHistory(); // new game
+    void ageHistory();   // next move of the same game
+
+private:
+    TranspositionTable &tt;
+    SearchShared *shared = nullptr;
+    unsigned int threadId;
+    uint64_t nodes = 0;
+    int rootDepth = 0; // depth of the current iteration
+    int selDepth = 0;  // deepest ply reached in the current iteration
+
+    // Per-ply state of the current line, indexed by ply
+    struct StackEntry
+    {
+        int staticEval = 0;  // NO_EVAL when in check
+        bool inCheck = false;
+        Move currentMove;    // move being searched from this ply, null for a null move
+        Move excludedMove;   // skipped by a singular-extension verification search
+        bool evalReady = false; // set around same-ply re-searches, which reuse the entry
+        Move killers[2];
+    };
+
+    StackEntry stack[MAX_PLY + 2];
+    int historyTable[6][64] = {};
+    Move counterMoves[2][6][64];                      // quiet reply that refuted [color][piece][to]
+    // [plies back - 1][side to move][previous piece][to][piece][to]: the opponent's
+    // last move and our own move before it are separate contexts
+    int16_t continuationHistory[2][2][6][64][6][64] = {};
+    int captureHistory[2][6][64][6] = {};             // [side to move][piece][to][captured piece]
+    Move pvTable[MAX_PLY + 2][MAX_PLY + 2]; // triangular PV: row ply is the best line from ply
+    int pvLength[MAX_PLY + 2] = {};         // where each row ends
+
+    bool shouldStop();
+    SearchInfo makeInfo(uint64_t totalNodes) const;
+    void updatePV(int ply, const Move &m);
+    void orderMoves(const Board &board, std::vector<Move> &moves, Move ttBestMove, int ply) const;
+    int captureScore(const Move &m, Piece victim) const;
+    int quietHistory(const Move &m, int ply) const;
+    void updateQuietHistory(const Move &m, int ply, int bonus);
+    int searchRoot(Board &board, std::vector<Move> &moves, int depth, int alpha, int beta,
+                   Move &bestMoveOut, bool storeTT = true);
+    template <SearchNode Node>
+    int negamax(Board &board, int depth, int alpha, int beta, Move &bestMoveOut, int ply,
+                bool allowNull = true);
+    int quiescence(Board &board, int alpha, int beta, int ply, int staticEval);
+    void fillStackEntry(Board &board, int ply);
 };
 
+// A search engine for one game: a worker per thread whose history carries
+// over between moves, and a TT supplied by the owner. Independent contexts
+// can search concurrently in one process.
+class SearchContext
+{
+public:
+    explicit SearchContext(TranspositionTable &tt);
+
+    SearchResult think(Board &board, const SearchLimits &limits);
+    void setThreads(unsigned int threads); // Lazy SMP: helper workers share the TT
+    unsigned int getThreads() const;
+    void newGame(); // forget history and clear the TT
+    Move ponderMove(Board &board, const Move &bestMove) const; // expected reply from the TT, or a null move
+
+private:
+    TranspositionTable &tt;
+    std::vector<std::unique_ptr<SearchWorker>> workers; // workers[0] runs on the calling thread
+};
+
+// Process-wide default context, used by the UCI loop and the CLI
 class Search
 {
 public:
     static SearchResult think(Board &board);
     static SearchResult think(Board &board, int maxDepth);  // Overloaded version with depth limit
-
-private:
-    static int negamax(Board &board, int depth, int alpha, int beta, uint64_t &nodes, Move &bestMoveOut, int ply);
-    static int quiescence(Board &board, int alpha, int beta, uint64_t &nodes);
+    static SearchResult think(Board &board, const SearchLimits &limits);
+    static void setThreads(unsigned int threads);
+    static unsigned int getThreads();
+    static Move ponderMove(Board &board, const Move &bestMove);
+    static void newGame();
+    static SearchContext &context();
 };
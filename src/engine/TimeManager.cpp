@@ -0,0 +1,51 @@
+#include "TimeManager.h"
+#include <algorithm>
+
+static constexpr int DEFAULT_MOVES_TO_GO = 30; // assumed moves left in sudden death
+static constexpr int MAX_MOVES_TO_GO = 50;
+static constexpr int HARD_LIMIT_FACTOR = 4;    // hard limit as a multiple of the soft limit
+static constexpr int MAX_CLOCK_PERCENT = 75;   // never plan to spend more of the clock on one move
+
+// Soft limit scale in percent, indexed by consecutive iterations with the same best move
+static constexpr int STABILITY_SCALE[] = {160, 130, 110, 100, 90, 80};
+static constexpr int STABILITY_MAX = sizeof(STABILITY_SCALE) / sizeof(STABILITY_SCALE[0]) - 1;
+static constexpr int SCORE_DROP_CAP = 100;     // drops beyond this get no extra time
+static constexpr int SCORE_DROP_MAX_BONUS = 50; // percent of extra time at the cap
+
+void TimeManager::allocate(const TimeControl &tc, int64_t &softMs, int64_t &hardMs)
+{
+    softMs = 0;
+    hardMs = 0;
+
+    if (tc.moveTime > 0)
+    {
+        softMs = hardMs = std::max<int64_t>(1, tc.moveTime - tc.overhead);
+        return;
+    }
+
+    if (tc.time <= 0)
+        return;
+
+    int64_t available = std::max<int64_t>(1, tc.time - tc.overhead);
+    int movesToGo = tc.movesToGo > 0 ? std::min(tc.movesToGo, MAX_MOVES_TO_GO) : DEFAULT_MOVES_TO_GO;
+
+    int64_t soft = available / movesToGo + tc.increment * 3 / 4;
+    int64_t hard = std::min(soft * HARD_LIMIT_FACTOR, available * MAX_CLOCK_PERCENT / 100);
+
+    hardMs = std::max<int64_t>(1, hard);
+    softMs = std::clamp<int64_t>(soft, 1, hardMs);
+}
+
+int64_t TimeManager::adjustSoftLimit(int64_t softMs, int64_t hardMs, int stableIterations, int scoreDrop)
+{
+    if (softMs <= 0)
+        return softMs;
+
+    int64_t scaled = softMs * STABILITY_SCALE[std::clamp(stableIterations, 0, STABILITY_MAX)] / 100;
+
+    // A falling score means the previous best move was refuted; think longer
+    if (scoreDrop > 0)
+        scaled = scaled * (100 + SCORE_DROP_MAX_BONUS * std::min(scoreDrop, SCORE_DROP_CAP) / SCORE_DROP_CAP) / 100;
+
+    return hardMs > 0 ? std::min(scaled, hardMs) : scaled;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+
+// Clock state from a UCI "go" command, all times in milliseconds
+struct TimeControl
+{
+    int64_t time = 0;      // our remaining time, 0 = not on a clock
+    int64_t increment = 0;
+    int movesToGo = 0;     // 0 = sudden death
+    int64_t moveTime = 0;  // fixed time per move, overrides the clock
+    int64_t overhead = 30; // UCI "Move Overhead": GUI/network latency to keep in reserve
+};
+
+// Splits the clock into a soft limit, checked between iterations and scaled
+// by how settled the search is, and a hard limit that aborts the search
+// mid-iteration. A limit of 0 means unlimited.
+class TimeManager
+{
+public:
+    static void allocate(const TimeControl &tc, int64_t &softMs, int64_t &hardMs);
+
+    // Soft limit after an iteration. stableIterations counts consecutive
+    // iterations with the same best move, scoreDrop is how far the score fell
+    // since the previous iteration (centipawns, <= 0 if it did not fall).
+    static int64_t adjustSoftLimit(int64_t softMs, int64_t hardMs, int stableIterations, int scoreDrop);
+};
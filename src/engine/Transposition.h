@@ -2,10 +2,10 @@
 
 #include "Board.h"
 
-#include <unordered_map>
-#include <shared_mutex>
+#include <atomic>
 #include <cstdint>
 #include <algorithm>
+#include <memory>
 
 enum class NodeType : uint8_t
 {
@@ -23,48 +23,99 @@ struct TTEntry
     Move bestMove{};
 };
 
+// Shared by all search threads without locks. Each slot holds the entry packed
+// into one 64-bit word plus the key XORed with that word, so a slot torn by a
+// concurrent write fails the key check instead of returning mixed data.
 class TranspositionTable
 {
     static constexpr size_t TABLE_SIZE = 1ULL << 22; // ~4M entries (~64MB)
-    std::vector<TTEntry> table;
 
-    inline TTEntry &entry(uint64_t hash) noexcept
+    struct Slot
     {
-        return table[hash & (TABLE_SIZE - 1)];
+        std::atomic<uint64_t> key{0};
+        std::atomic<uint64_t> data{0};
+    };
+    std::unique_ptr<Slot[]> table;
+
+    // data layout: score (bits 0-31), depth (32-39), type (40-41), move (48-63)
+    static uint64_t pack(int depth, int score, NodeType type, const Move &m) noexcept
+    {
+        uint64_t move = static_cast<uint64_t>(m.from) |
+                        static_cast<uint64_t>(m.to) << 6 |
+                        static_cast<uint64_t>(m.isPromotion) << 12 |
+                        static_cast<uint64_t>(m.piece) << 13;
+        return static_cast<uint64_t>(static_cast<uint32_t>(score)) |
+               static_cast<uint64_t>(static_cast<uint8_t>(depth)) << 32 |
+               static_cast<uint64_t>(type) << 40 |
+               move << 48;
+    }
+
+    static void unpack(uint64_t data, TTEntry &out) noexcept
+    {
+        out.score = static_cast<int32_t>(static_cast<uint32_t>(data));
+        out.depth = static_cast<int8_t>(static_cast<uint8_t>(data >> 32));
+        out.type = static_cast<NodeType>((data >> 40) & 3);
+
+        uint64_t move = data >> 48;
+        out.bestMove = Move{};
+        out.bestMove.from = static_cast<int>(move & 63);
+        out.bestMove.to = static_cast<int>((move >> 6) & 63);
+        out.bestMove.isPromotion = (move >> 12) & 1;
+        out.bestMove.piece = static_cast<Piece>((move >> 13) & 7);
+        if (out.bestMove.isPromotion)
+            out.bestMove.promotionPiece = out.bestMove.piece;
     }
 
 public:
-    TranspositionTable() : table(TABLE_SIZE) {}
+    TranspositionTable() : table(new Slot[TABLE_SIZE]) {}
 
     bool probe(uint64_t hash, TTEntry &out) const noexcept
     {
-        const TTEntry &e = table[hash & (TABLE_SIZE - 1)];
-        if (e.key == hash)
+        const Slot &s = table[hash & (TABLE_SIZE - 1)];
+        uint64_t key = s.key.load(std::memory_order_relaxed);
+        uint64_t data = s.data.load(std::memory_order_relaxed);
+        if ((key ^ data) == hash)
         {
-            out = e;
+            out.key = hash;
+            unpack(data, out);
             return true;
         }
         return false;
     }
 
-    // Replacement strategy: always-replace if different position or if new depth >= existing depth
-    // This is an aggressive replacement strategy that favors newer/deeper entries
+    // Replacement strategy: the same position is replaced by an entry at least as deep;
+    // a different position is always replaced by a main-search entry (depth > 0), but a
+    // quiescence entry (depth 0) never evicts a deeper entry, which ordering and ponder need
     void store(uint64_t hash, int depth, int score, NodeType type, const Move& bestMove) noexcept
     {
-        TTEntry& e = table[hash & (TABLE_SIZE - 1)];
-        if (e.key != hash || depth >= e.depth)
+        Slot &s = table[hash & (TABLE_SIZE - 1)];
+        uint64_t oldData = s.data.load(std::memory_order_relaxed);
+        uint64_t oldKey = s.key.load(std::memory_order_relaxed) ^ oldData;
+        int oldDepth = static_cast<int8_t>(static_cast<uint8_t>(oldData >> 32));
+        bool replace = oldKey == hash ? depth >= oldDepth : depth > 0 || depth >= oldDepth;
+        if (replace)
         {
-            e.key = hash;
-            e.depth = depth;
-            e.score = score;
-            e.type = type;
-            e.bestMove = bestMove;
+            uint64_t data = pack(depth, score, type, bestMove);
+            s.key.store(hash ^ data, std::memory_order_relaxed);
+            s.data.store(data, std::memory_order_relaxed);
         }
     }
 
+    // Permille of a sample of slots that hold an entry, for UCI hashfull
+    int hashfull() const noexcept
+    {
+        int used = 0;
+        for (size_t i = 0; i < 1000; ++i)
+            used += table[i].data.load(std::memory_order_relaxed) != 0;
+        return used;
+    }
+
     void clear() noexcept
     {
-        for (auto &e : table)
-            e.key = 0;
+        for (size_t i = 0; i < TABLE_SIZE; ++i)
+        {
+            table[i].key.store(0, std::memory_order_relaxed);
+            table[i].data.store(0, std::memory_order_relaxed);
+        }
     }
-};
\ No newline at end of file
+};
@@ -9,6 +9,23 @@
 
 Board UCI::currentBoard;
 bool UCI::isInitialized = false;
+static constexpr int MAX_MULTI_PV = 64;
+
+int UCI::moveOverhead = 30;
+int UCI::multiPV = 1;
+std::thread UCI::searchThread;
+std::mutex UCI::searchMutex;
+std::condition_variable UCI::searchCv;
+bool UCI::searchPending = false;
+bool UCI::searchRunning = false;
+bool UCI::searchThreadExit = false;
+Board UCI::searchBoard;
+SearchLimits UCI::searchLimits;
+std::atomic<bool> UCI::stopRequested{false};
+std::atomic<bool> UCI::pondering{false};
+bool UCI::searchInfinite = false;
+std::atomic<bool> UCI::ponderEnabled{false};
+std::mutex UCI::outputMutex;
 
 std::vector<std::string> UCI::split(const std::string &s)
 {
@@ -38,6 +55,15 @@ void UCI::run()
 
         processCommand(line);
     }
+
+    shutdownSearchThread();
+}
+
+// Output is shared with the search thread, so whole lines are written under a lock
+void UCI::send(const std::string &line)
+{
+    std::lock_guard<std::mutex> lock(outputMutex);
+    std::cout << line << std::endl;
 }
 
 void UCI::processCommand(const std::string &command)
@@ -116,6 +142,10 @@ void UCI::processCommand(const std::string &command)
     {
         stop();
     }
+    else if (cmd == "ponderhit")
+    {
+        ponderhit();
+    }
     else if (cmd == "quit")
     {
         quit();
@@ -124,22 +154,22 @@ void UCI::processCommand(const std::string &command)
 
 void UCI::uci()
 {
-    std::cout << "id name Chess Engine" << std::endl;
-    std::cout << "id author Your Name" << std::endl;
+    send("id name Chess Engine");
+    send("id author Your Name");
 
     // Report UCI options (required by lichess-bot)
-    std::cout << "option name Threads type spin default 1 min 1 max 1" << std::endl;
-    std::cout << "option name Hash type spin default 64 min 1 max 1024" << std::endl;
-    std::cout << "option name Clear Hash type button" << std::endl;
-    std::cout << "option name Ponder type check default false" << std::endl;
-    std::cout << "option name MultiPV type spin default 1 min 1 max 1" << std::endl;
-    std::cout << "option name Skill Level type spin default 20 min 0 max 20" << std::endl;
-    std::cout << "option name Move Overhead type spin default 30 min 0 max 5000" << std::endl;
-    std::cout << "option name Slow Mover type spin default 89 min 10 max 1000" << std::endl;
-    std::cout << "option name nodestime type spin default 0 min 0 max 10000" << std::endl;
-    std::cout << "option name UCI_Chess960 type check default false" << std::endl;
-
-    std::cout << "uciok" << std::endl;
+    send("option name Threads type spin default 1 min 1 max " + std::to_string(maxThreads()));
+    send("option name Hash type spin default 64 min 1 max 1024");
+    send("option name Clear Hash type button");
+    send("option name Ponder type check default false");
+    send("option name MultiPV type spin default 1 min 1 max " + std::to_string(MAX_MULTI_PV));
+    send("option name Skill Level type spin default 20 min 0 max 20");
+    send("option name Move Overhead type spin default 30 min 0 max 5000");
+    send("option name Slow Mover type spin default 89 min 10 max 1000");
+    send("option name nodestime type spin default 0 min 0 max 10000");
+    send("option name UCI_Chess960 type check default false");
+
+    send("uciok");
 }
 
 void UCI::debug(bool on)
@@ -149,7 +179,7 @@ void UCI::debug(bool on)
 
 void UCI::isready()
 {
-    std::cout << "readyok" << std::endl;
+    send("readyok");
 }
 
 void UCI::setoption(const std::string &option)
@@ -188,10 +218,43 @@ void UCI::setoption(const std::string &option)
     {
         optionValue = tokens[valueIdx + 1];
     }
+
+    try
+    {
+        if (optionName == "Threads" && !optionValue.empty())
+        {
+            int threads = std::stoi(optionValue);
+            stopAndWait(); // the running search still uses the workers
+            Search::setThreads(std::clamp(threads, 1, static_cast<int>(maxThreads())));
+        }
+        else if (optionName == "Move Overhead" && !optionValue.empty())
+        {
+            moveOverhead = std::clamp(std::stoi(optionValue), 0, 5000);
+        }
+        else if (optionName == "MultiPV" && !optionValue.empty())
+        {
+            multiPV = std::clamp(std::stoi(optionValue), 1, MAX_MULTI_PV);
+        }
+        else if (optionName == "Ponder")
+        {
+            ponderEnabled = optionValue == "true";
+        }
+    }
+    catch (const std::exception &e)
+    {
+        // Malformed value - keep the current setting
+    }
+}
+
+unsigned int UCI::maxThreads()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
 }
 
 void UCI::ucinewgame()
 {
+    stopAndWait();
+    Search::newGame();
     currentBoard.setBoard();
     currentBoard.hash = currentBoard.computeZobrist();
     currentBoard.repetitionCount.clear();
@@ -283,12 +346,13 @@ void UCI::position(const std::string &fen, const std::vector<std::string> &moves
     }
 }
 
-int UCI::parseDepth(const std::string &params)
+// Value following "name" in a go command, 0 if absent
+int UCI::parseValue(const std::string &params, const std::string &name)
 {
     std::vector<std::string> tokens = split(params);
     for (size_t i = 0; i < tokens.size(); i++)
     {
-        if (tokens[i] == "depth" && i + 1 < tokens.size())
+        if (tokens[i] == name && i + 1 < tokens.size())
         {
             return std::stoi(tokens[i + 1]);
         }
@@ -296,54 +360,179 @@ int UCI::parseDepth(const std::string &params)
     return 0;
 }
 
+int UCI::parseDepth(const std::string &params)
+{
+    return parseValue(params, "depth");
+}
+
 int UCI::parseTimeLimit(const std::string &params, bool isWhite)
+{
+    return parseValue(params, isWhite ? "wtime" : "btime");
+}
+
+int UCI::parseIncrement(const std::string &params, bool isWhite)
+{
+    return parseValue(params, isWhite ? "winc" : "binc");
+}
+
+int UCI::parseMoveTime(const std::string &params)
+{
+    return parseValue(params, "movetime");
+}
+
+uint64_t UCI::parseNodes(const std::string &params)
 {
     std::vector<std::string> tokens = split(params);
-    for (size_t i = 0; i < tokens.size(); i++)
+    auto it = std::find(tokens.begin(), tokens.end(), "nodes");
+    if (it == tokens.end() || std::next(it) == tokens.end())
+        return 0;
+    return std::stoull(*std::next(it));
+}
+
+// Moves following "searchmoves", up to the first token that is not a legal move
+std::vector<Move> UCI::parseSearchMoves(const std::string &params, Board &board)
+{
+    std::vector<Move> searchMoves;
+    std::vector<std::string> tokens = split(params);
+    auto it = std::find(tokens.begin(), tokens.end(), "searchmoves");
+    if (it == tokens.end())
+        return searchMoves;
+
+    std::vector<Move> legal;
+    MoveGen::generateLegalMoves(board, legal);
+    for (++it; it != tokens.end(); ++it)
     {
-        std::string token = tokens[i];
-        if (isWhite && token == "wtime" && i + 1 < tokens.size())
-        {
-            return std::stoi(tokens[i + 1]);
-        }
-        else if (!isWhite && token == "btime" && i + 1 < tokens.size())
-        {
-            return std::stoi(tokens[i + 1]);
-        }
+        auto match = std::find_if(legal.begin(), legal.end(), [&](const Move &m)
+                                  { return Move::moveToString(m) == *it; });
+        if (match == legal.end())
+            break;
+        searchMoves.push_back(*match);
     }
-    return 0;
+    return searchMoves;
 }
 
-int UCI::parseMoveTime(const std::string &params)
+void UCI::go(const std::string &params)
 {
+    SearchLimits limits;
+    TimeControl tc;
+    try
+    {
+        limits.depth = parseDepth(params);
+        tc.time = parseTimeLimit(params, currentBoard.whiteToMove);
+        tc.increment = parseIncrement(params, currentBoard.whiteToMove);
+        tc.movesToGo = parseValue(params, "movestogo");
+        tc.moveTime = parseMoveTime(params);
+        limits.nodes = parseNodes(params);
+        limits.mate = parseValue(params, "mate");
+    }
+    catch (const std::exception &e)
+    {
+        // Malformed numbers - search with whatever was parsed
+    }
+    tc.overhead = moveOverhead;
+    TimeManager::allocate(tc, limits.softTimeMs, limits.timeMs);
+
     std::vector<std::string> tokens = split(params);
-    for (size_t i = 0; i < tokens.size(); i++)
+    bool infinite = std::find(tokens.begin(), tokens.end(), "infinite") != tokens.end();
+    limits.searchMoves = parseSearchMoves(params, currentBoard);
+
+    // Without any limit, fall back to a fixed depth
+    if (limits.depth <= 0 && limits.timeMs == 0 && limits.nodes == 0 && limits.mate <= 0 && !infinite)
+        limits.depth = 10;
+
+    // A go during a search is a protocol error; finish the old one first so
+    // every go gets exactly one bestmove
+    stopAndWait();
+
+    std::lock_guard<std::mutex> lock(searchMutex);
+    if (!searchThread.joinable())
+        searchThread = std::thread(searchLoop);
+
+    stopRequested = false;
+    limits.stop = &stopRequested;
+    searchInfinite = infinite;
+    pondering = std::find(tokens.begin(), tokens.end(), "ponder") != tokens.end();
+    limits.ponder = &pondering;
+    limits.multiPV = multiPV;
+    limits.info = reportInfo;
+    searchBoard = currentBoard;
+    searchLimits = limits;
+    searchPending = true;
+    searchCv.notify_all();
+}
+
+void UCI::searchLoop()
+{
+    while (true)
     {
-        if (tokens[i] == "movetime" && i + 1 < tokens.size())
+        Board board;
+        SearchLimits limits;
         {
-            return std::stoi(tokens[i + 1]);
+            std::unique_lock<std::mutex> lock(searchMutex);
+            searchCv.wait(lock, []
+                          { return searchPending || searchThreadExit; });
+            if (!searchPending)
+                return;
+            board = searchBoard;
+            limits = searchLimits;
+            searchPending = false;
+            searchRunning = true;
         }
+
+        SearchResult result = Search::think(board, limits);
+
+        // bestmove must not be sent while pondering or in go infinite, even if
+        // the search ended early (e.g. a forced mate); hold it until ponderhit
+        // or stop
+        {
+            std::unique_lock<std::mutex> lock(searchMutex);
+            searchCv.wait(lock, []
+                          { return (!pondering && !searchInfinite) || stopRequested; });
+        }
+        reportBestMove(board, result);
+
+        {
+            std::lock_guard<std::mutex> lock(searchMutex);
+            searchRunning = false;
+        }
+        searchCv.notify_all();
     }
-    return 0;
 }
 
-void UCI::go(const std::string &params)
+void UCI::reportInfo(const SearchInfo &info)
 {
-    int depth = parseDepth(params);
-    int moveTime = parseMoveTime(params);
-    int timeLimit = parseTimeLimit(params, currentBoard.whiteToMove);
+    std::ostringstream line;
+    line << "info depth " << info.depth << " seldepth " << info.selDepth;
 
-    int maxDepth = depth > 0 ? depth : 10; // Default depth if not specified
+    // An empty PV is a progress report from inside a long iteration
+    if (!info.pv.empty())
+    {
+        line << " multipv " << info.multiPV;
+        if (info.mateIn != 0)
+            line << " score mate " << info.mateIn;
+        else
+            line << " score cp " << info.score;
+    }
 
-    Color expectedColor = currentBoard.whiteToMove ? WHITE : BLACK;
+    line << " nodes " << info.nodes << " nps " << info.nps << " hashfull " << info.hashfull
+         << " time " << info.timeMs;
 
-    auto start = std::chrono::steady_clock::now();
-    SearchResult result = Search::think(currentBoard, maxDepth);
-    auto end = std::chrono::steady_clock::now();
+    if (!info.pv.empty())
+    {
+        line << " pv";
+        for (const auto &m : info.pv)
+            line << " " << Move::moveToString(m);
+    }
+    send(line.str());
+}
+
+void UCI::reportBestMove(Board &board, SearchResult result)
+{
+    Color expectedColor = board.whiteToMove ? WHITE : BLACK;
 
     // Get all legal moves for validation
     std::vector<Move> legalMoves;
-    MoveGen::generateLegalMoves(currentBoard, legalMoves);
+    MoveGen::generateLegalMoves(board, legalMoves);
 
     // Ensure the best move is for the correct side
     if (result.bestMove.from != 0 || result.bestMove.to != 0)
@@ -361,21 +550,80 @@ void UCI::go(const std::string &params)
             }
         }
 
-        std::string moveStr = Move::moveToString(result.bestMove);
-        std::cout << "bestmove " << moveStr << std::endl;
+        std::string line = "bestmove " + Move::moveToString(result.bestMove);
+        if (ponderEnabled)
+        {
+            Move reply = result.pv.size() > 1 ? result.pv[1] : Search::ponderMove(board, result.bestMove);
+            if (reply.from != reply.to)
+                line += " ponder " + Move::moveToString(reply);
+        }
+        send(line);
     }
     else
     {
-        std::cout << "bestmove 0000" << std::endl; // Null move if no legal moves
+        send("bestmove 0000"); // Null move if no legal moves
+    }
+}
+
+// Ends any running search, including a held go ponder or go infinite, and
+// returns once its bestmove has been sent
+void UCI::stopAndWait()
+{
+    {
+        std::lock_guard<std::mutex> lock(searchMutex);
+        stopRequested = true;
+        pondering = false;
+        searchInfinite = false;
+    }
+    searchCv.notify_all();
+    waitForSearch();
+}
+
+void UCI::waitForSearch()
+{
+    std::unique_lock<std::mutex> lock(searchMutex);
+    searchCv.wait(lock, []
+                  { return !searchPending && !searchRunning; });
+}
+
+void UCI::shutdownSearchThread()
+{
+    stop();
+    {
+        std::lock_guard<std::mutex> lock(searchMutex);
+        searchThreadExit = true;
     }
+    searchCv.notify_all();
+    if (searchThread.joinable())
+        searchThread.join();
 }
 
 void UCI::stop()
 {
-    // Stop searching - not fully implemented (would need threading)
+    // Picked up by the search within LIMIT_CHECK_INTERVAL nodes; the search
+    // thread then prints bestmove. After a go ponder that bestmove is for the
+    // position the opponent did not play and the GUI discards it.
+    {
+        std::lock_guard<std::mutex> lock(searchMutex);
+        stopRequested = true;
+    }
+    searchCv.notify_all();
+}
+
+// The opponent played the expected move: the running search carries on as a
+// normal timed search, keeping its tree, with ponder time counted against the
+// clock limits from the go ponder command
+void UCI::ponderhit()
+{
+    {
+        std::lock_guard<std::mutex> lock(searchMutex);
+        pondering = false;
+    }
+    searchCv.notify_all();
 }
 
 void UCI::quit()
 {
+    shutdownSearchThread();
     exit(0);
 }
@@ -2,8 +2,13 @@
 #include "board/Board.h"
 #include "board/MoveGen.h"
 #include "engine/Search.h"
+#include "engine/TimeManager.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <string>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 class UCI
@@ -15,6 +20,24 @@ public:
 private:
     static Board currentBoard;
     static bool isInitialized;
+    static int moveOverhead;
+    static int multiPV;
+
+    // Searches run on a persistent worker thread so the input loop keeps
+    // answering stop/isready/quit; searchMutex guards the job fields below
+    static std::thread searchThread;
+    static std::mutex searchMutex;
+    static std::condition_variable searchCv;
+    static bool searchPending;
+    static bool searchRunning;
+    static bool searchThreadExit;
+    static Board searchBoard;
+    static SearchLimits searchLimits;
+    static std::atomic<bool> stopRequested;
+    static std::atomic<bool> pondering; // go ponder until ponderhit or stop
+    static bool searchInfinite;         // go infinite: bestmove waits for stop
+    static std::atomic<bool> ponderEnabled; // UCI "Ponder" option: report a ponder move
+    static std::mutex outputMutex;
     
     static void uci();
     static void debug(bool on);
@@ -24,12 +47,26 @@ private:
     static void position(const std::string &fen, const std::vector<std::string> &moves = {});
     static void go(const std::string &params);
     static void stop();
+    static void ponderhit();
     static void quit();
     
+    static int parseValue(const std::string &params, const std::string &name);
     static int parseDepth(const std::string &params);
     static int parseTimeLimit(const std::string &params, bool isWhite);
+    static int parseIncrement(const std::string &params, bool isWhite);
     static int parseMoveTime(const std::string &params);
+    static uint64_t parseNodes(const std::string &params);
+    static std::vector<Move> parseSearchMoves(const std::string &params, Board &board);
+    static unsigned int maxThreads();
     
+    static void searchLoop();
+    static void stopAndWait();
+    static void waitForSearch();
+    static void shutdownSearchThread();
+    static void reportBestMove(Board &board, SearchResult result);
+    static void send(const std::string &line);
+    static void reportInfo(const SearchInfo &info);
+
     static std::vector<std::string> split(const std::string &s);
 };
 
@@ -0,0 +1,78 @@
+#include "board/Magic.h"
+#include "board/MoveGen.h"
+#include "board/Zobrist.h"
+#include "engine/DeepPerft.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+static void printUsage()
+{
+    std::cout << "Usage: deep_perft --depth N [--fen FEN] [--split S] [--procs P]\n"
+                 "                  [--threads T] [--checkpoint FILE] [--quiet]\n\n"
+                 "Splits the tree at depth S (default 3) into work units run by P forked\n"
+                 "worker processes (default: all cores), each using T perft threads\n"
+                 "(default 1). Finished units are appended to FILE; rerunning with the\n"
+                 "same arguments resumes from it.\n";
+}
+
+int main(int argc, char **argv)
+{
+    DeepPerftConfig config;
+    config.processes = std::max(1u, std::thread::hardware_concurrency());
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string
+            {
+                if (i + 1 >= argc)
+                    throw std::invalid_argument("missing value for " + arg);
+                return argv[++i];
+            };
+
+            if (arg == "--depth")
+                config.depth = std::stoi(value());
+            else if (arg == "--fen")
+                config.fen = value();
+            else if (arg == "--split")
+                config.splitDepth = std::stoi(value());
+            else if (arg == "--procs")
+                config.processes = std::stoi(value());
+            else if (arg == "--threads")
+                config.threads = std::stoi(value());
+            else if (arg == "--checkpoint")
+                config.checkpointPath = value();
+            else if (arg == "--quiet")
+                config.verbose = false;
+            else
+            {
+                printUsage();
+                return arg == "--help" ? 0 : 1;
+            }
+        }
+
+        MoveGen::initAttackTables();
+        initZobristKeys();
+        initMagicBitboards();
+
+        auto start = std::chrono::steady_clock::now();
+        uint64_t nodes = deepPerft(config);
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+
+        std::cout << "perft(" << config.depth << ") = " << nodes << " in " << seconds << "s\n";
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
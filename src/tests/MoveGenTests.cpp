@@ -94,4 +94,24 @@ TEST(MoveGen, CheckMate2)
     MoveGen::generateLegalMoves(board, moves);
     EXPECT_TRUE(moves.empty());
     EXPECT_TRUE(MoveGen::inCheck(board, WHITE));
-}
\ No newline at end of file
+}
+// ----------------- Null Move Tests -----------------
+TEST(MoveGen, NullMoveUpdatesSideEnPassantAndHash)
+{
+    initZobristKeys();
+    Board board;
+    board.setCustomBoard("rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 3");
+    uint64_t before = board.hash;
+
+    MoveState state;
+    MoveGen::makeNullMove(board, state);
+    EXPECT_TRUE(board.whiteToMove);
+    EXPECT_EQ(board.enPassantSquare, -1);
+    EXPECT_EQ(board.hash, board.computeZobrist());
+    EXPECT_NE(board.hash, before);
+
+    MoveGen::unmakeNullMove(board, state);
+    EXPECT_FALSE(board.whiteToMove);
+    EXPECT_EQ(board.enPassantSquare, Board::squareFromString("e3"));
+    EXPECT_EQ(board.hash, before);
+}
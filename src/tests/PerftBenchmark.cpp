@@ -0,0 +1,358 @@
+#include "PerftBenchmark.h"
+#include "Perft.h"
+#include "Board.h"
+#include "Magic.h"
+#include "MoveGen.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+struct BenchPosition
+{
+    const char *fen;
+    int depth;
+    uint64_t expected;
+};
+
+// Fixed workload so NPS figures are comparable between commits
+static const BenchPosition BENCH_SUITE[] = {
+    {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609ULL},
+    {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603ULL},
+    {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6, 11030083ULL},
+    {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5, 15833292ULL},
+    {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487ULL},
+};
+
+static int envInt(const char *name, int fallback)
+{
+    const char *env = std::getenv(name);
+    return env ? std::atoi(env) : fallback;
+}
+
+BenchConfig BenchConfig::fromEnv()
+{
+    BenchConfig config;
+    config.threads = std::clamp(envInt("PERFT_THREADS", 1), 1, 64);
+    config.enabled = envInt("PERFT_BENCH", 1) != 0;
+    config.runs = std::clamp(envInt("PERFT_RUNS", 5), 1, 1000);
+    config.warmup = std::clamp(envInt("PERFT_WARMUP", 1), 0, 100);
+    if (const char *env = std::getenv("PERFT_OUT"))
+        config.outFile = env;
+    if (const char *env = std::getenv("PERFT_BASELINE"))
+        config.baselineFile = env;
+    return config;
+}
+
+std::string getGitHash()
+{
+    std::string hash = "unknown";
+#ifdef _WIN32
+    FILE *pipe = _popen("git rev-parse --short HEAD 2>nul", "r");
+#else
+    FILE *pipe = popen("git rev-parse --short HEAD 2>/dev/null", "r");
+#endif
+    if (pipe)
+    {
+        char buffer[64];
+        if (fgets(buffer, sizeof(buffer), pipe))
+            hash = std::string(buffer);
+#ifdef _WIN32
+        _pclose(pipe);
+#else
+        pclose(pipe);
+#endif
+    }
+    hash.erase(std::remove(hash.begin(), hash.end(), '\n'), hash.end());
+    return hash;
+}
+
+std::string getCompilerId()
+{
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_FULL_VER);
+#else
+    return "unknown";
+#endif
+}
+
+std::string getCpuModel()
+{
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.rfind("model name", 0) == 0)
+        {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos)
+            {
+                size_t start = line.find_first_not_of(' ', colon + 1);
+                return start == std::string::npos ? "unknown" : line.substr(start);
+            }
+        }
+    }
+    if (const char *env = std::getenv("PROCESSOR_IDENTIFIER"))
+        return env;
+    return "unknown";
+}
+
+static double percentile(std::vector<double> values, double p)
+{
+    if (values.empty())
+        return 0.0;
+    std::sort(values.begin(), values.end());
+    double pos = p * (values.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = std::min(lo + 1, values.size() - 1);
+    double frac = pos - lo;
+    return values[lo] + (values[hi] - values[lo]) * frac;
+}
+
+double BenchResult::medianSeconds() const { return percentile(seconds, 0.5); }
+double BenchResult::percentileSeconds(double p) const { return percentile(seconds, p); }
+double BenchResult::medianNps() const { return percentile(nps, 0.5); }
+
+static std::string jsonEscape(const std::string &s)
+{
+    std::string out;
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+std::string BenchResult::toJson() const
+{
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(4);
+    json << "{\"timestamp\":\"" << jsonEscape(timestamp) << "\""
+         << ",\"commit\":\"" << jsonEscape(gitHash) << "\""
+         << ",\"compiler\":\"" << jsonEscape(compiler) << "\""
+         << ",\"cpu\":\"" << jsonEscape(cpu) << "\""
+         << ",\"threads\":" << threads
+         << ",\"runs\":" << seconds.size()
+         << ",\"nodes\":" << nodes
+         << ",\"median_s\":" << medianSeconds()
+         << ",\"p10_s\":" << percentileSeconds(0.1)
+         << ",\"p90_s\":" << percentileSeconds(0.9)
+         << ",\"median_nps\":" << std::setprecision(0) << medianNps()
+         << ",\"nps_samples\":[";
+    for (size_t i = 0; i < nps.size(); ++i)
+        json << (i ? "," : "") << nps[i];
+    json << "]}";
+    return json.str();
+}
+
+BenchResult runPerftBenchmark(const BenchConfig &config)
+{
+    MoveGen::initAttackTables();
+    initMagicBitboards();
+
+    std::vector<Board> boards;
+    for (const auto &pos : BENCH_SUITE)
+    {
+        Board board;
+        board.trackRepetitions = false;
+        board.setCustomBoard(pos.fen);
+        boards.push_back(board);
+    }
+
+    auto runSuite = [&]()
+    {
+        uint64_t total = 0;
+        for (size_t i = 0; i < boards.size(); ++i)
+        {
+            uint64_t nodes = perftTest(boards[i], BENCH_SUITE[i].depth, config.threads);
+            if (nodes != BENCH_SUITE[i].expected)
+                throw std::runtime_error(std::string("perft mismatch on ") + BENCH_SUITE[i].fen);
+            total += nodes;
+        }
+        return total;
+    };
+
+    BenchResult result;
+    result.gitHash = getGitHash();
+    result.compiler = getCompilerId();
+    result.cpu = getCpuModel();
+    result.threads = config.threads;
+
+    for (int i = 1; i <= config.warmup; ++i)
+    {
+        std::cout << "Warm-up " << i << "/" << config.warmup << "..." << std::flush;
+        runSuite();
+        std::cout << " done\n";
+    }
+
+    for (int i = 1; i <= config.runs; ++i)
+    {
+        std::cout << "Run " << i << "/" << config.runs << "..." << std::flush;
+        auto start = std::chrono::steady_clock::now();
+        uint64_t nodes = runSuite();
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+
+        result.nodes = nodes;
+        result.seconds.push_back(seconds);
+        result.nps.push_back(seconds > 0.0 ? nodes / seconds : 0.0);
+        std::cout << " done (" << std::fixed << std::setprecision(3) << seconds << "s)\n";
+    }
+
+    auto t = std::time(nullptr);
+    std::ostringstream ts;
+    ts << std::put_time(std::localtime(&t), "%Y-%m-%d %H:%M:%S");
+    result.timestamp = ts.str();
+    return result;
+}
+
+void appendBenchResult(const std::string &path, const BenchResult &result)
+{
+    std::ofstream out(path, std::ios::app);
+    out << result.toJson() << "\n";
+}
+
+// Minimal field extraction for the records written by BenchResult::toJson
+static bool jsonString(const std::string &line, const std::string &key, std::string &out)
+{
+    std::string needle = "\"" + key + "\":\"";
+    size_t pos = line.find(needle);
+    if (pos == std::string::npos)
+        return false;
+    out.clear();
+    for (size_t i = pos + needle.size(); i < line.size(); ++i)
+    {
+        if (line[i] == '\\' && i + 1 < line.size())
+            out += line[++i];
+        else if (line[i] == '"')
+            return true;
+        else
+            out += line[i];
+    }
+    return false;
+}
+
+static bool jsonNumber(const std::string &line, const std::string &key, double &out)
+{
+    std::string needle = "\"" + key + "\":";
+    size_t pos = line.find(needle);
+    if (pos == std::string::npos)
+        return false;
+    out = std::strtod(line.c_str() + pos + needle.size(), nullptr);
+    return true;
+}
+
+static std::vector<double> jsonNumberArray(const std::string &line, const std::string &key)
+{
+    std::vector<double> values;
+    std::string needle = "\"" + key + "\":[";
+    size_t pos = line.find(needle);
+    if (pos == std::string::npos)
+        return values;
+    size_t end = line.find(']', pos);
+    std::istringstream iss(line.substr(pos + needle.size(), end - pos - needle.size()));
+    std::string token;
+    while (std::getline(iss, token, ','))
+        values.push_back(std::strtod(token.c_str(), nullptr));
+    return values;
+}
+
+// One-sided 95% critical values of Student's t for 1..30 degrees of freedom
+static double tCritical95(double df)
+{
+    static const double table[30] = {
+        6.314, 2.920, 2.353, 2.132, 2.015, 1.943, 1.895, 1.860, 1.833, 1.812,
+        1.796, 1.782, 1.771, 1.761, 1.753, 1.746, 1.740, 1.734, 1.729, 1.725,
+        1.721, 1.717, 1.714, 1.711, 1.708, 1.706, 1.703, 1.701, 1.699, 1.697};
+    int idx = static_cast<int>(std::floor(df));
+    if (idx < 1)
+        return table[0];
+    if (idx > 30)
+        return 1.645;
+    return table[idx - 1];
+}
+
+static void meanVariance(const std::vector<double> &v, double &mean, double &var)
+{
+    mean = std::accumulate(v.begin(), v.end(), 0.0) / v.size();
+    var = 0.0;
+    for (double x : v)
+        var += (x - mean) * (x - mean);
+    var = v.size() > 1 ? var / (v.size() - 1) : 0.0;
+}
+
+BenchComparison compareWithBaseline(const std::string &path, const BenchResult &result)
+{
+    BenchComparison cmp;
+    std::ifstream in(path);
+    std::string line;
+    std::vector<double> baseline;
+
+    // Only records from the same compiler, CPU, thread count and workload are comparable
+    while (std::getline(in, line))
+    {
+        std::string compiler, cpu;
+        double threads = 0, nodes = 0;
+        if (!jsonString(line, "compiler", compiler) || !jsonString(line, "cpu", cpu) ||
+            !jsonNumber(line, "threads", threads) || !jsonNumber(line, "nodes", nodes))
+            continue;
+        if (compiler != result.compiler || cpu != result.cpu ||
+            static_cast<unsigned int>(threads) != result.threads ||
+            static_cast<uint64_t>(nodes) != result.nodes)
+            continue;
+
+        std::vector<double> samples = jsonNumberArray(line, "nps_samples");
+        if (!samples.empty())
+            baseline = samples;
+    }
+
+    if (baseline.empty() || result.nps.empty())
+        return cmp;
+
+    cmp.found = true;
+    cmp.baselineNps = percentile(baseline, 0.5);
+    cmp.currentNps = result.medianNps();
+    cmp.changePercent = cmp.baselineNps > 0.0 ? 100.0 * (cmp.currentNps / cmp.baselineNps - 1.0) : 0.0;
+
+    // Welch's t-test needs a variance estimate from both sides
+    if (result.nps.size() < 2 || baseline.size() < 2)
+    {
+        cmp.insufficientSamples = true;
+        return cmp;
+    }
+
+    // Welch's t-test, one-sided: is the current NPS lower than the baseline?
+    double m1, v1, m2, v2;
+    meanVariance(result.nps, m1, v1);
+    meanVariance(baseline, m2, v2);
+    double n1 = result.nps.size(), n2 = baseline.size();
+    double se2 = v1 / n1 + v2 / n2;
+    if (se2 <= 0.0)
+        return cmp; // identical samples on both sides: nothing to test against
+
+    cmp.tStatistic = (m1 - m2) / std::sqrt(se2);
+    double denom = 0.0;
+    if (n1 > 1)
+        denom += (v1 / n1) * (v1 / n1) / (n1 - 1);
+    if (n2 > 1)
+        denom += (v2 / n2) * (v2 / n2) / (n2 - 1);
+    double df = denom > 0.0 ? se2 * se2 / denom : 1.0;
+
+    cmp.significantSlowdown = cmp.tStatistic < -tCritical95(df);
+    return cmp;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Settings for the perft benchmark runner, read from the environment:
+//   PERFT_THREADS   threads passed to perftTest (default 1)
+//   PERFT_BENCH     0 disables the benchmark, correctness tests only (default 1)
+//   PERFT_RUNS      timed repetitions (default 5)
+//   PERFT_WARMUP    untimed warm-up repetitions (default 1)
+//   PERFT_OUT       JSONL file results are appended to (default perft_benchmarks.jsonl)
+//   PERFT_BASELINE  JSONL file to compare against; the last matching record is used
+struct BenchConfig
+{
+    unsigned int threads = 1;
+    bool enabled = true;
+    int runs = 5;
+    int warmup = 1;
+    std::string outFile = "perft_benchmarks.jsonl";
+    std::string baselineFile;
+
+    static BenchConfig fromEnv();
+};
+
+struct BenchResult
+{
+    std::string timestamp;
+    std::string gitHash;
+    std::string compiler;
+    std::string cpu;
+    unsigned int threads = 1;
+    uint64_t nodes = 0;             // nodes per repetition
+    std::vector<double> seconds;    // wall-clock time of each timed repetition
+    std::vector<double> nps;        // nodes per second of each timed repetition
+
+    double medianSeconds() const;
+    double percentileSeconds(double p) const;
+    double medianNps() const;
+    std::string toJson() const;
+};
+
+struct BenchComparison
+{
+    bool found = false;          // a comparable baseline record exists
+    double baselineNps = 0.0;    // median NPS of the baseline
+    double currentNps = 0.0;     // median NPS of this run
+    double changePercent = 0.0;  // positive = faster
+    double tStatistic = 0.0;     // Welch's t on the NPS samples
+    bool insufficientSamples = false; // fewer than 2 samples on a side, no test was run
+    bool significantSlowdown = false;
+};
+
+std::string getGitHash();
+std::string getCompilerId();
+std::string getCpuModel();
+
+BenchResult runPerftBenchmark(const BenchConfig &config);
+void appendBenchResult(const std::string &path, const BenchResult &result);
+BenchComparison compareWithBaseline(const std::string &path, const BenchResult &result);
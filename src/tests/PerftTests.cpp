@@ -1,9 +1,12 @@
 #include "Perft.h"
+#include "DeepPerft.h"
 #include "Board.h"
 #include "Magic.h"
 #include "MoveGen.h"
 #include "Zobrist.h"
 #include <algorithm>
+#include <cstdio>
+#include <fstream>
 
 #include <gtest/gtest.h>
 
@@ -208,4 +211,54 @@ TEST_F(PerftTest, Position5Depth4)
 TEST_F(PerftTest, Position5Depth5)
 {
     EXPECT_EQ(perftTest(position5, 5, threads), 89941194u);
-}
\ No newline at end of file
+}
+// ----------------- Deep Perft Driver -----------------
+#ifndef _WIN32
+TEST_F(PerftTest, DeepPerftMatchesPerft)
+{
+    DeepPerftConfig config;
+    config.depth = 5;
+    config.splitDepth = 2;
+    config.processes = 2;
+    config.verbose = false;
+    EXPECT_EQ(deepPerft(config), 4865609u);
+}
+
+TEST_F(PerftTest, DeepPerftResumesFromCheckpoint)
+{
+    const std::string path = "deep_perft_test.ckpt";
+    std::remove(path.c_str());
+
+    DeepPerftConfig config;
+    config.fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+    config.depth = 4;
+    config.splitDepth = 2;
+    config.processes = 2;
+    config.checkpointPath = path;
+    config.verbose = false;
+    EXPECT_EQ(deepPerft(config), 4085603u);
+
+    // Simulate an interrupted run: keep half the units and a torn last line
+    std::vector<std::string> lines;
+    {
+        std::ifstream in(path);
+        std::string line;
+        while (std::getline(in, line))
+            lines.push_back(line);
+    }
+    ASSERT_GT(lines.size(), 2u);
+    {
+        std::ofstream out(path, std::ios::trunc);
+        for (size_t i = 0; i < lines.size() / 2; ++i)
+            out << lines[i] << "\n";
+        out << lines[lines.size() / 2].substr(0, 3);
+    }
+
+    EXPECT_EQ(deepPerft(config), 4085603u);
+
+    // A checkpoint from a different run must not be reused
+    config.depth = 3;
+    EXPECT_THROW(deepPerft(config), std::runtime_error);
+    std::remove(path.c_str());
+}
+#endif
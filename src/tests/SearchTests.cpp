@@ -2,9 +2,13 @@
 #include "Magic.h"
 #include "MoveGen.h"
 #include "Search.h"
+#include "TimeManager.h"
 #include "Zobrist.h"
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
 
 class SearchTest : public ::testing::Test
 {
@@ -20,6 +24,7 @@ protected:
     void SetUp() override
     {
         board = Board();
+        Search::newGame(); // history and TT carry over between searches otherwise
     }
 
     Board board;
@@ -89,4 +94,353 @@ TEST_F(SearchTest, Black_HangingBishop)
     board.setCustomBoard("rnbqkbnr/pp1p1ppp/2p5/1B2p3/4P3/2N5/PPPP1PPP/R1BQK1NR b KQkq - 1 3");
     SearchResult result = Search::think(board);
     EXPECT_EQ(Move::moveToString(result.bestMove), "c6b5");
-}
\ No newline at end of file
+}
+// ----------------- Iterative Deepening -----------------
+TEST_F(SearchTest, IterationsAreRecorded)
+{
+    board.setBoard();
+    board.hash = board.computeZobrist();
+    SearchResult result = Search::think(board, 4);
+    ASSERT_EQ(result.iterations.size(), 4u);
+    for (size_t i = 0; i < result.iterations.size(); ++i)
+        EXPECT_EQ(result.iterations[i].depth, static_cast<int>(i) + 1);
+    EXPECT_EQ(result.depth, 4);
+    EXPECT_EQ(Move::moveToString(result.bestMove), Move::moveToString(result.iterations.back().bestMove));
+}
+
+TEST_F(SearchTest, NodeLimitStopsSearch)
+{
+    board.setBoard();
+    board.hash = board.computeZobrist();
+    SearchLimits limits;
+    limits.nodes = 50000;
+    SearchResult result = Search::think(board, limits);
+    EXPECT_GE(result.depth, 1);
+    EXPECT_LE(result.nodes, limits.nodes);
+
+    std::vector<Move> legal;
+    MoveGen::generateLegalMoves(board, legal);
+    bool found = false;
+    for (const auto &m : legal)
+        found |= Move::moveToString(m) == Move::moveToString(result.bestMove);
+    EXPECT_TRUE(found);
+}
+
+TEST_F(SearchTest, LazySmpFindsMate)
+{
+    board.setCustomBoard("6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1");
+    board.hash = board.computeZobrist();
+    Search::setThreads(4);
+    SearchResult result = Search::think(board, 4);
+    Search::setThreads(1);
+    EXPECT_EQ(Move::moveToString(result.bestMove), "d1d8");
+    EXPECT_GT(result.score, 900000);
+}
+
+// ----------------- Time Management Tests -----------------
+TEST(TimeManagerTest, ClockAllocationStaysWithinBudget)
+{
+    TimeControl tc;
+    tc.time = 60000;
+    tc.increment = 1000;
+    int64_t soft, hard;
+    TimeManager::allocate(tc, soft, hard);
+    EXPECT_GT(soft, 0);
+    EXPECT_LE(soft, hard);
+    EXPECT_LT(hard, tc.time - tc.overhead);
+
+    // One move to the time control may use most, but never all, of the clock
+    tc.increment = 0;
+    tc.movesToGo = 1;
+    TimeManager::allocate(tc, soft, hard);
+    EXPECT_LT(hard, tc.time - tc.overhead);
+    EXPECT_GT(soft, tc.time / 2);
+
+    // Bullet with less time left than the overhead still gets a positive budget
+    tc.time = 20;
+    TimeManager::allocate(tc, soft, hard);
+    EXPECT_GE(soft, 1);
+    EXPECT_GE(hard, soft);
+}
+
+TEST(TimeManagerTest, MoveTimeAndNoClock)
+{
+    TimeControl tc;
+    tc.moveTime = 1000;
+    int64_t soft, hard;
+    TimeManager::allocate(tc, soft, hard);
+    EXPECT_EQ(soft, 1000 - tc.overhead);
+    EXPECT_EQ(hard, soft);
+
+    TimeManager::allocate(TimeControl{}, soft, hard);
+    EXPECT_EQ(soft, 0);
+    EXPECT_EQ(hard, 0);
+}
+
+TEST(TimeManagerTest, UnstableSearchGetsMoreTime)
+{
+    int64_t stable = TimeManager::adjustSoftLimit(1000, 4000, 5, 0);
+    int64_t changed = TimeManager::adjustSoftLimit(1000, 4000, 0, 0);
+    int64_t dropped = TimeManager::adjustSoftLimit(1000, 4000, 5, 80);
+    EXPECT_LT(stable, 1000);
+    EXPECT_GT(changed, 1000);
+    EXPECT_GT(dropped, stable);
+    EXPECT_LE(TimeManager::adjustSoftLimit(3000, 4000, 0, 500), 4000);
+}
+
+TEST_F(SearchTest, TimeLimitReturnsCompletedIteration)
+{
+    board.setBoard();
+    board.hash = board.computeZobrist();
+    SearchLimits limits;
+    limits.timeMs = 100;
+    limits.softTimeMs = 50;
+
+    auto start = std::chrono::steady_clock::now();
+    SearchResult result = Search::think(board, limits);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+    EXPECT_LT(elapsed, 300);
+    ASSERT_FALSE(result.iterations.empty());
+    EXPECT_EQ(result.depth, result.iterations.back().depth);
+    EXPECT_EQ(Move::moveToString(result.bestMove), Move::moveToString(result.iterations.back().bestMove));
+}
+
+TEST_F(SearchTest, StopFlagAbortsSearchFromAnotherThread)
+{
+    board.setBoard();
+    board.hash = board.computeZobrist();
+    std::atomic<bool> stop{false};
+    SearchLimits limits;
+    limits.stop = &stop;
+
+    std::thread stopper([&]
+                        {
+                            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                            stop = true;
+                        });
+    auto start = std::chrono::steady_clock::now();
+    SearchResult result = Search::think(board, limits);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+    stopper.join();
+
+    EXPECT_LT(elapsed, 500);
+    EXPECT_GE(result.depth, 1);
+    EXPECT_FALSE(Move::moveToString(result.bestMove).empty());
+}
+
+TEST_F(SearchTest, PonderSuspendsTimeLimitUntilPonderhit)
+{
+    board.setBoard();
+    board.hash = board.computeZobrist();
+    std::atomic<bool> ponder{true};
+    SearchLimits limits;
+    limits.timeMs = 20;
+    limits.ponder = &ponder;
+
+    std::thread opponent([&]
+                         {
+                             std::this_thread::sleep_for(std::chrono::milliseconds(150));
+                             ponder = false;
+                         });
+    auto start = std::chrono::steady_clock::now();
+    SearchResult result = Search::think(board, limits);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+    opponent.join();
+
+    EXPECT_GE(elapsed, 150);
+    EXPECT_LT(elapsed, 500);
+
+    // The expected reply comes from the TT and must be legal after the best move
+    Move reply = Search::ponderMove(board, result.bestMove);
+    ASSERT_NE(reply.from, reply.to);
+    MoveState st;
+    MoveGen::makeMove(board, result.bestMove, st);
+    std::vector<Move> legal;
+    MoveGen::generateLegalMoves(board, legal);
+    bool found = false;
+    for (const auto &m : legal)
+        found |= Move::moveToString(m) == Move::moveToString(reply);
+    EXPECT_TRUE(found);
+}
+
+TEST_F(SearchTest, MultiPVReportsDistinctLines)
+{
+    board.setBoard();
+    board.hash = board.computeZobrist();
+    SearchLimits limits;
+    limits.depth = 4;
+    limits.multiPV = 3;
+    int reports = 0;
+    limits.info = [&](const SearchInfo &info)
+    {
+        EXPECT_GE(info.multiPV, 1);
+        EXPECT_LE(info.multiPV, 3);
+        reports++;
+    };
+    SearchResult result = Search::think(board, limits);
+
+    ASSERT_EQ(result.lines.size(), 3u);
+    EXPECT_EQ(reports, 4 * 3);
+    EXPECT_EQ(Move::moveToString(result.lines[0].move), Move::moveToString(result.bestMove));
+    EXPECT_EQ(result.lines[0].score, result.score);
+    EXPECT_NE(Move::moveToString(result.lines[0].move), Move::moveToString(result.lines[1].move));
+    EXPECT_NE(Move::moveToString(result.lines[0].move), Move::moveToString(result.lines[2].move));
+    EXPECT_NE(Move::moveToString(result.lines[1].move), Move::moveToString(result.lines[2].move));
+}
+
+TEST_F(SearchTest, PrincipalVariationIsLegalLine)
+{
+    board.setCustomBoard("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    board.hash = board.computeZobrist();
+    SearchResult result = Search::think(board, 5);
+
+    ASSERT_GE(result.pv.size(), 2u);
+    EXPECT_EQ(Move::moveToString(result.pv.front()), Move::moveToString(result.bestMove));
+    EXPECT_GT(result.selDepth, result.depth); // captures are resolved past the horizon
+    ASSERT_EQ(result.iterations.size(), 5u);
+    EXPECT_EQ(result.iterations.back().pv.size(), result.pv.size());
+
+    // Every PV move must be legal in the position it is played from
+    Board line = board;
+    for (const auto &pvMove : result.pv)
+    {
+        std::vector<Move> legal;
+        MoveGen::generateLegalMoves(line, legal);
+        auto it = std::find_if(legal.begin(), legal.end(), [&](const Move &m)
+                               { return Move::moveToString(m) == Move::moveToString(pvMove); });
+        ASSERT_NE(it, legal.end()) << Move::moveToString(pvMove);
+        MoveState st;
+        MoveGen::makeMove(line, *it, st);
+    }
+}
+
+TEST_F(SearchTest, InfoReportsMateDistance)
+{
+    board.setCustomBoard("r1bqkbnr/pppp1ppp/2n5/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 0 1");
+    board.hash = board.computeZobrist();
+    SearchLimits limits;
+    limits.depth = 3;
+    int mateIn = 0;
+    limits.info = [&](const SearchInfo &info)
+    {
+        if (!info.pv.empty())
+            mateIn = info.mateIn;
+    };
+    Search::think(board, limits);
+    EXPECT_EQ(mateIn, 1);
+}
+
+TEST_F(SearchTest, MateDistanceSurvivesTranspositionTable)
+{
+    board.setCustomBoard("8/6k1/8/8/8/8/R7/1R2K3 w - - 0 1");
+    board.hash = board.computeZobrist();
+    SearchLimits limits;
+    limits.depth = 8;
+    int mateIn = 0;
+    limits.info = [&](const SearchInfo &info)
+    {
+        if (!info.pv.empty())
+            mateIn = info.mateIn;
+    };
+
+    // The second search starts from a TT full of mate scores stored at other plies
+    SearchResult first = Search::think(board, limits);
+    int firstMateIn = mateIn;
+    SearchResult second = Search::think(board, limits);
+
+    EXPECT_EQ(firstMateIn, 3);
+    EXPECT_EQ(mateIn, firstMateIn);
+    EXPECT_EQ(second.score, first.score);
+    EXPECT_LT(second.nodes, first.nodes);
+}
+
+TEST_F(SearchTest, SearchMovesRestrictRoot)
+{
+    // Rb8# is the obvious move; the root is limited to quiet king moves
+    board.setCustomBoard("6k1/R7/1R6/8/8/8/8/4K3 w - - 12 7");
+    board.hash = board.computeZobrist();
+    SearchLimits limits;
+    limits.depth = 4;
+    limits.searchMoves = {Move::fromUCIString("e1d2", board), Move::fromUCIString("e1f2", board)};
+    SearchResult result = Search::think(board, limits);
+
+    std::string best = Move::moveToString(result.bestMove);
+    EXPECT_TRUE(best == "e1d2" || best == "e1f2") << best;
+}
+
+TEST_F(SearchTest, MateLimitBoundsDepth)
+{
+    board.setCustomBoard("8/6k1/8/8/8/8/R7/1R2K3 w - - 0 1");
+    board.hash = board.computeZobrist();
+    SearchLimits limits;
+    limits.mate = 1; // there is no mate in one, so only a single ply is searched
+    SearchResult result = Search::think(board, limits);
+    EXPECT_EQ(result.depth, 1);
+
+    limits.mate = 3;
+    result = Search::think(board, limits);
+    EXPECT_LE(result.depth, 5);
+    EXPECT_GT(result.score, 999000);
+}
+
+TEST_F(SearchTest, IndependentContextsSearchConcurrently)
+{
+    TranspositionTable ttA, ttB;
+    SearchContext contextA(ttA), contextB(ttB);
+
+    Board boardA, boardB;
+    boardA.setCustomBoard("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    boardA.hash = boardA.computeZobrist();
+    boardB.setCustomBoard("r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP1B1PPP/R2QKB1R w KQ - 0 8");
+    boardB.hash = boardB.computeZobrist();
+
+    SearchLimits limits;
+    limits.depth = 6;
+    SearchResult expectedA = contextA.think(boardA, limits);
+    SearchResult expectedB = contextB.think(boardB, limits);
+
+    // From the same fresh state, searches running side by side must not
+    // disturb each other
+    contextA.newGame();
+    contextB.newGame();
+    SearchResult resultA, resultB;
+    std::thread other([&]
+                      { resultB = contextB.think(boardB, limits); });
+    resultA = contextA.think(boardA, limits);
+    other.join();
+
+    EXPECT_EQ(resultA.nodes, expectedA.nodes);
+    EXPECT_EQ(resultB.nodes, expectedB.nodes);
+    EXPECT_EQ(Move::moveToString(resultA.bestMove), Move::moveToString(expectedA.bestMove));
+    EXPECT_EQ(Move::moveToString(resultB.bestMove), Move::moveToString(expectedB.bestMove));
+}
+
+TEST_F(SearchTest, QuiescenceEntryKeepsDeeperEntry)
+{
+    TranspositionTable tt;
+    const uint64_t deepKey = 0x123456789ULL;
+    const uint64_t otherKey = deepKey ^ (1ULL << 40); // same slot, different position
+    Move m{};
+    m.from = 12;
+    m.to = 28;
+
+    tt.store(deepKey, 8, 35, NodeType::EXACT, m);
+    tt.store(otherKey, 0, -20, NodeType::UPPERBOUND, Move{});
+
+    TTEntry entry;
+    ASSERT_TRUE(tt.probe(deepKey, entry));
+    EXPECT_EQ(entry.depth, 8);
+    EXPECT_EQ(entry.bestMove.to, 28);
+    EXPECT_FALSE(tt.probe(otherKey, entry));
+
+    // A main-search entry still takes the slot
+    tt.store(otherKey, 1, 10, NodeType::EXACT, Move{});
+    EXPECT_TRUE(tt.probe(otherKey, entry));
+}
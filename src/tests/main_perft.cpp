@@ -1,113 +1,95 @@
+#include "PerftBenchmark.h"
+
 #include <gtest/gtest.h>
 #include <chrono>
-#include <fstream>
 #include <iomanip>
-#include <ctime>
 #include <iostream>
-#include <cstdlib>
-#include <algorithm>
-#include <string>
-#include <vector>
-#include <numeric>
-
-static std::string getGitHash()
-{
-    std::string hash = "unknown";
-#ifdef _WIN32
-    FILE *pipe = _popen("git rev-parse --short HEAD 2>nul", "r");
-#else
-    FILE *pipe = popen("git rev-parse --short HEAD 2>/dev/null", "r");
-#endif
-    if (pipe)
-    {
-        char buffer[64];
-        if (fgets(buffer, sizeof(buffer), pipe))
-            hash = std::string(buffer);
-#ifdef _WIN32
-        _pclose(pipe);
-#else
-        pclose(pipe);
-#endif
-    }
-    hash.erase(std::remove(hash.begin(), hash.end(), '\n'), hash.end());
-    return hash;
-}
+#include <stdexcept>
 
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
 
-    unsigned int threads = 1;
-    if (const char *env = std::getenv("PERFT_THREADS"))
-        threads = std::clamp(std::atoi(env), 1, 64);
+    BenchConfig config = BenchConfig::fromEnv();
+    unsigned int threads = config.threads;
 
-    std::string gitHash = getGitHash();
+    std::cout << "[Perft] Running with " << threads << " thread"
+              << (threads > 1 ? "s" : "") << "...\n";
 
-    if (threads == 1)
-    {
-        std::cout << "[Perft Benchmark] Running single threaded perft 5x\n";
+    auto start = std::chrono::steady_clock::now();
+    int result = RUN_ALL_TESTS();
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
 
-        std::vector<double> runTimes;
-        for (int i = 1; i <= 5; ++i)
-        {
-            std::cout << "Run " << i << "/5..." << std::flush;
-            auto start = std::clock();
-            (void)RUN_ALL_TESTS();
-            auto end = std::clock();
-            double seconds = static_cast<double>(end - start) / CLOCKS_PER_SEC;
-            runTimes.push_back(seconds);
-            std::cout << " done (" << std::fixed << std::setprecision(3) << seconds << "s)\n";
-        }
+    std::cout << "Perft tests completed in " << std::fixed << std::setprecision(3) << seconds
+              << "s with " << threads << " thread" << (threads > 1 ? "s" : "") << "\n";
+
+    // Timing a broken move generator is meaningless
+    if (result != 0 || !config.enabled)
+        return result;
 
-        double avg = std::accumulate(runTimes.begin(), runTimes.end(), 0.0) / runTimes.size();
+    std::cout << "\n[Perft Benchmark] " << config.warmup << " warm-up, " << config.runs
+              << " timed run" << (config.runs > 1 ? "s" : "") << "\n";
 
-        auto t = std::time(nullptr);
-        std::ostringstream line;
-        line << std::put_time(std::localtime(&t), "%Y-%m-%d %H:%M:%S")
-             << " | Total time: " << std::accumulate(runTimes.begin(), runTimes.end(), 0.0) << "s"
-             << " | Average: " << avg << "s"
-             << " | Commit: " << gitHash;
+    BenchResult bench;
+    try
+    {
+        bench = runPerftBenchmark(config);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Benchmark failed: " << e.what() << "\n";
+        return 1;
+    }
 
-        std::vector<std::string> benchmarks, normal;
+    std::cout << "\n=== Benchmark Summary ===\n";
+    std::cout << std::setprecision(3);
+    std::cout << "Nodes/run: " << bench.nodes << "\n";
+    std::cout << "Median:    " << bench.medianSeconds() << "s"
+              << " (p10 " << bench.percentileSeconds(0.1) << "s, p90 "
+              << bench.percentileSeconds(0.9) << "s)\n";
+    std::cout << "NPS:       " << std::setprecision(0) << bench.medianNps() << "\n";
+    std::cout << "Commit:    " << bench.gitHash << "\n";
+    std::cout << "Compiler:  " << bench.compiler << "\n";
+    std::cout << "CPU:       " << bench.cpu << "\n";
+
+    // Compare before appending so a baseline file equal to the output file
+    // is compared against its previous record, not this one
+    int exitCode = 0;
+    if (!config.baselineFile.empty())
+    {
+        BenchComparison cmp = compareWithBaseline(config.baselineFile, bench);
+        if (!cmp.found)
+        {
+            std::cout << "\nNo comparable baseline in " << config.baselineFile << "\n";
+        }
+        else
         {
-            std::ifstream in("perft_benchmarks.txt");
-            std::string l;
-            while (std::getline(in, l))
+            std::cout << "\n=== Baseline Comparison ===\n";
+            std::cout << "Baseline NPS: " << std::setprecision(0) << cmp.baselineNps << "\n";
+            std::cout << "Current NPS:  " << cmp.currentNps << "\n";
+            std::cout << "Change:       " << std::setprecision(2) << std::showpos
+                      << cmp.changePercent << "%" << std::noshowpos;
+            if (!cmp.insufficientSamples)
+                std::cout << " (Welch t = " << cmp.tStatistic << ")";
+            std::cout << "\n";
+            if (cmp.insufficientSamples)
+            {
+                std::cout << "Insufficient samples for a significance test (need at least 2 runs on each side)\n";
+            }
+            else if (cmp.significantSlowdown)
             {
-                if (l.find("Benchmark") != std::string::npos)
-                    benchmarks.push_back(l);
-                else
-                    normal.push_back(l);
+                std::cout << "SLOWDOWN: statistically significant at 95%\n";
+                exitCode = 2;
+            }
+            else
+            {
+                std::cout << "No significant slowdown\n";
             }
         }
-
-        benchmarks.push_back(line.str());
-
-        std::ofstream out("perft_benchmarks.txt", std::ios::trunc);
-        for (const auto &l : benchmarks)
-            out << l << "\n";
-        for (const auto &l : normal)
-            out << l << "\n";
-
-        std::cout << "\n=== Benchmark Summary ===\n";
-        std::cout << "Average: " << avg << "s\n";
-        std::cout << "Commit: " << gitHash << "\n";
-        std::cout << "Results appended to perft_benchmarks.txt\n";
-        return 0;
     }
 
-    std::cout << "[Perft] Running with " << threads << " thread"
-              << (threads > 1 ? "s" : "") << "...\n";
-
-    auto start = std::clock();
-    int result = RUN_ALL_TESTS();
-    auto end = std::clock();
-
-    double seconds = static_cast<double>(end - start) / CLOCKS_PER_SEC;
-
-    std::cout << "Perft tests completed in " << seconds << "s with " << threads
-              << " thread" << (threads > 1 ? "s" : "")
-              << " (commit " << gitHash << ")\n";
-
-    return result;
+    appendBenchResult(config.outFile, bench);
+    std::cout << "Results appended to " << config.outFile << "\n";
+    return exitCode;
 }